@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "Arduino.h"
+#include "Config.h"
+#include "TempFilter.h"
+#include "MedianFilter.h"
+
+/*
+ * Feeds synthetic probes through the filter chain of TempSensor, one stage after another, and reports for each stage:
+ * time per sample, mean error against the clean signal and how many times plain comparison with the set point would
+ * switch a relay. The signal is a slow sine around #RELAY_TEMP_SET_POINT_0 with uniform noise and a broken read from
+ * time to time.
+ *
+ * Fails when any filtered stage switches more often than raw probes.
+ *
+ * Usage: filter_bench [samples] [noise in 0.1 degree] [seed]
+ */
+
+static const char* STAGE_NAMES[] = { "raw", "spike", "median", "ema", "kalman" };
+
+int main(int argc, char** argv) {
+	uint32_t samples = argc > 1 ? strtoul(argv[1], NULL, 10) : 100000;
+	uint32_t noise = argc > 2 ? strtoul(argv[2], NULL, 10) : 5;
+	uint32_t seed = argc > 3 ? strtoul(argv[3], NULL, 10) : 1;
+
+	const uint8_t stages = (uint8_t) FilterStage::AMOUNT;
+	std::vector<temp_t> clean(samples);
+	std::vector<std::vector<temp_t>> out(stages, std::vector<temp_t>(samples));
+	for (uint32_t i = 0; i < samples; i++) {
+		seed = seed * 1103515245 + 12345;
+		clean[i] = RELAY_TEMP_SET_POINT_0 + lround(20 * sin(i * 2 * M_PI / 2000));
+		int32_t sample = clean[i] + (int32_t) ((seed >> 16) % (2 * noise + 1)) - (int32_t) noise;
+		if (i % 97 == 50) {
+			sample = (i & 1) ? temp_deg(85) : temp_deg(-127);
+		}
+		out[0][i] = sample;
+	}
+
+	// the same wiring as in TempSensor
+	SpikeFilter spikeFilter(FilterStage::RAW);
+	MedianFilter medianFilter(FilterStage::SPIKE);
+	EmaFilter emaFilter(FilterStage::MEDIAN);
+	KalmanFilter kalmanFilter(FilterStage::SPIKE);
+	TempFilter* filters[] = { &spikeFilter, &medianFilter, &emaFilter, &kalmanFilter };
+
+	double ns[stages] = { };
+	for (uint8_t fIdx = 0; fIdx < stages - 1; fIdx++) {
+		TempFilter* filter = filters[fIdx];
+		std::vector<temp_t>& in = out[(uint8_t) filter->input];
+		std::vector<temp_t>& res = out[fIdx + 1];
+		auto start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < samples; i++) {
+			res[i] = filter->add(in[i]);
+		}
+		auto end = std::chrono::steady_clock::now();
+		ns[fIdx + 1] = std::chrono::duration<double, std::nano>(end - start).count() / samples;
+	}
+
+	printf("%-8s %10s %10s %10s\n", "stage", "ns/sample", "error", "switches");
+	uint32_t rawSwitches = 0;
+	boolean failed = false;
+	for (uint8_t sIdx = 0; sIdx < stages; sIdx++) {
+		uint32_t switches = 0;
+		double error = 0;
+		boolean on = out[sIdx][0] > RELAY_TEMP_SET_POINT_0;
+		for (uint32_t i = 0; i < samples; i++) {
+			boolean nowOn = out[sIdx][i] > RELAY_TEMP_SET_POINT_0;
+			if (nowOn != on) {
+				switches++;
+				on = nowOn;
+			}
+			error += fabs(out[sIdx][i] - clean[i]);
+		}
+		if (sIdx == 0) {
+			rawSwitches = switches;
+		} else if (switches > rawSwitches) {
+			failed = true;
+		}
+		printf("%-8s %10.1f %10.2f %10lu\n", STAGE_NAMES[sIdx], ns[sIdx], samples == 0 ? 0 : error / samples,
+				(unsigned long) switches);
+	}
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+
+#include "Arduino.h"
+#include "Host.h"
+#include "Recorder.h"
+#include "Config.h"
+
+/*
+ * Runs the firmware natively: setup() once and then loop() for given amount of iterations. Virtual clock advances
+ * by a fixed step after each loop() call, so that every run executes exactly the same code path. Duty cycle is the
+ * part of the virtual clock not spent in idle sleep - thermostat_busy is the same firmware with sleep disabled.
+ *
+ * With #stimulus every given amount of loops temperature changes and NEXT button gets pressed, this way the recorder
+ * has something to record.
+ *
+ * Usage: thermostat [loops] [us per loop] [stimulus]
+ */
+
+void setup();
+void loop();
+
+int main(int argc, char** argv) {
+	uint32_t loops = argc > 1 ? strtoul(argv[1], NULL, 10) : 10000000;
+	uint32_t usPerLoop = argc > 2 ? strtoul(argv[2], NULL, 10) : 10;
+	uint32_t stimulus = argc > 3 ? strtoul(argv[3], NULL, 10) : 0;
+
+	host_reset();
+	setup();
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < loops; i++) {
+		if (stimulus > 0 && i > 0 && i % stimulus == 0) {
+			uint32_t step = i / stimulus;
+			host_setTempC(15 + (step * 7) % 17);
+			host_interrupt(digitalPinToInterrupt(DIG_PIN_BUTTON_NEXT));
+		}
+		loop();
+		host_advanceUs(usPerLoop);
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double wallNs = std::chrono::duration<double, std::nano>(end - start).count();
+	printf("loops:           %lu\n", (unsigned long) loops);
+	printf("simulated time:  %.3f s\n", host_ns() / 1e9);
+	printf("wall time:       %.3f s\n", wallNs / 1e9);
+	printf("ns per loop:     %.1f\n", loops == 0 ? 0 : wallNs / loops);
+	printf("loops per sec:   %.0f\n", wallNs == 0 ? 0 : loops / (wallNs / 1e9));
+	printf("sleep time:      %.3f s\n", host_sleepNs() / 1e9);
+	printf("duty cycle:      %.2f %%\n", host_ns() == 0 ? 0 : 100.0 * (host_ns() - host_sleepNs()) / host_ns());
+	printf("conversions/min: %.1f\n", host_ns() == 0 ? 0 : host_conversions() / (host_ns() / 60e9));
+#if ENABLE_RECORDER
+	rec_dump();
+#endif
+	return 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "Config.h"
+#include "RollingMinMax.h"
+
+/*
+ * Feeds a random walk of probes taken every #ST_ACTUAL_PROBE_MS into RollingMinMax and into a naive version that scans
+ * all buckets of the window on every probe, compares results and reports time per probe of both.
+ *
+ * Fails on first difference.
+ *
+ * Usage: minmax_bench [days] [seed]
+ */
+
+const static uint32_t BUCKET_MS = ST_ROLLING_MS / ST_ROLLING_BUCKETS;
+
+int main(int argc, char** argv) {
+	uint32_t days = argc > 1 ? strtoul(argv[1], NULL, 10) : 7;
+	uint32_t seed = argc > 2 ? strtoul(argv[2], NULL, 10) : 1;
+
+	uint32_t probes = days * (ST_DAY_MS / ST_ACTUAL_PROBE_MS);
+	std::vector<uint32_t> ms(probes);
+	std::vector<temp_t> temps(probes);
+	int32_t temp = temp_deg(20);
+	uint32_t now = 0;
+	for (uint32_t i = 0; i < probes; i++) {
+		seed = seed * 1103515245 + 12345;
+		temp += (int32_t) ((seed >> 16) % 3) - 1;
+		temp = max(min(temp, (int32_t) temp_deg(60)), (int32_t) temp_deg(-30));
+
+		// from time to time sensor stops for a few hours
+		now += i % 50000 == 49999 ? ((seed >> 8) % 20) * BUCKET_MS : ST_ACTUAL_PROBE_MS;
+		ms[i] = now;
+		temps[i] = temp;
+	}
+
+	RollingMinMax rolling;
+	std::vector<temp_t> rollingMin(probes), rollingMax(probes);
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < probes; i++) {
+		rolling.add(ms[i], temps[i]);
+		rollingMin[i] = rolling.getMin();
+		rollingMax[i] = rolling.getMax();
+	}
+	auto end = std::chrono::steady_clock::now();
+	double rollingNs = std::chrono::duration<double, std::nano>(end - start).count() / probes;
+
+	// naive: min and max for each bucket in the window, window is scanned with each probe
+	std::vector<temp_t> bucketMin(ST_ROLLING_BUCKETS), bucketMax(ST_ROLLING_BUCKETS);
+	std::vector<uint32_t> bucketSeq(ST_ROLLING_BUCKETS, UINT32_MAX);
+	uint32_t firstMs = ms.empty() ? 0 : ms[0];
+	uint32_t errors = 0;
+	start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < probes; i++) {
+		uint32_t seq = (ms[i] - firstMs) / BUCKET_MS;
+		uint8_t bIdx = seq % ST_ROLLING_BUCKETS;
+		if (bucketSeq[bIdx] != seq) {
+			bucketSeq[bIdx] = seq;
+			bucketMin[bIdx] = temps[i];
+			bucketMax[bIdx] = temps[i];
+		} else {
+			bucketMin[bIdx] = min(bucketMin[bIdx], temps[i]);
+			bucketMax[bIdx] = max(bucketMax[bIdx], temps[i]);
+		}
+		temp_t tMin = temps[i], tMax = temps[i];
+		for (uint8_t b = 0; b < ST_ROLLING_BUCKETS; b++) {
+			if (bucketSeq[b] != UINT32_MAX && seq - bucketSeq[b] < ST_ROLLING_BUCKETS) {
+				tMin = min(tMin, bucketMin[b]);
+				tMax = max(tMax, bucketMax[b]);
+			}
+		}
+		if (tMin != rollingMin[i] || tMax != rollingMax[i]) {
+			if (errors++ == 0) {
+				printf("probe %lu: %d/%d expected %d/%d\n", (unsigned long) i, rollingMin[i], rollingMax[i], tMin,
+						tMax);
+			}
+		}
+	}
+	end = std::chrono::steady_clock::now();
+	double naiveNs = std::chrono::duration<double, std::nano>(end - start).count() / probes;
+
+	printf("probes:          %lu\n", (unsigned long) probes);
+	printf("rolling ns:      %.1f\n", rollingNs);
+	printf("naive ns:        %.1f\n", naiveNs);
+	printf("rolling bytes:   %lu\n", (unsigned long) sizeof(RollingMinMax));
+	printf("errors:          %lu\n", (unsigned long) errors);
+	return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "Host.h"
+#include "Recorder.h"
+
+/*
+ * Replays trace dumped by Recorder through the firmware: runs setup() and loop() on the virtual clock and feeds
+ * recorded inputs - button events and temperature changes - at their time stamps, exactly like interrupts and the
+ * sensor would. Everything else (relays, suspend/resume) is produced again by the firmware and the whole trace recorded
+ * during replay is compared with the original one.
+ *
+ * Trace dumped after the ring has wrapped starts mid-run: the firmware boots with the sensor seeded from the first
+ * recorded temperature and runs up to the first entry, so its state before the trace is a guess. Entries within
+ * #WARM_UP_MS from the start of the trace are replayed, but not compared. Relay events are not compared at all, relay
+ * state and switch delays reach before the trace. Sensor phase is not known either, so temperature can be read up to
+ * #TS_PROBE_MAX_MS later than it was recorded, temperatures and events are compared as separate streams.
+ *
+ * Usage: thermostat_replay <trace> [us per loop]
+ */
+
+void setup();
+void loop();
+
+/* Part of mid-run trace that is replayed, but not compared. */
+const static uint32_t WARM_UP_MS = 30000;
+
+static std::vector<RecEntry> trace;
+static uint32_t traceTotal = 0;
+
+/* Next entry to be checked by applyInputs(). */
+static size_t nextIdx = 0;
+
+static boolean readTrace(const char* path) {
+	FILE* file = fopen(path, "r");
+	if (file == NULL) {
+		return false;
+	}
+	char line[128];
+	while (fgets(line, sizeof(line), file) != NULL) {
+		unsigned long ms, total, size;
+		unsigned int type, sourceId;
+		int value;
+		if (sscanf(line, "RC BEGIN %lu %lu", &total, &size) == 2) {
+			traceTotal = total;
+
+		} else if (sscanf(line, "RC %lu %u %u %d", &ms, &type, &sourceId, &value) == 4) {
+			RecEntry entry;
+			entry.ms = ms;
+			entry.type = type;
+			entry.sourceId = sourceId;
+			entry.value = value;
+			trace.push_back(entry);
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+static boolean isInput(const RecEntry* entry) {
+	return entry->type == REC_TEMP || entry->type == static_cast<uint8_t>(BusEvent::BUTTON_NEXT)
+			|| entry->type == static_cast<uint8_t>(BusEvent::BUTTON_PREV)
+			|| entry->type == static_cast<uint8_t>(BusEvent::CLEAR_STATS);
+}
+
+/* Applies inputs recorded up to now, called before each loop() and on each wake up from sleep. */
+static void applyInputs() {
+	uint32_t ms = millis();
+	while (nextIdx < trace.size() && trace[nextIdx].ms <= ms) {
+		const RecEntry* entry = &trace[nextIdx++];
+		if (!isInput(entry)) {
+			continue;
+		}
+		if (entry->type == REC_TEMP) {
+			host_setTempC((float) entry->value / TEMP_UNIT);
+		} else {
+			BusMsg msg = eb_msg(static_cast<BusEvent>(entry->type), entry->sourceId);
+			msg.data.value = entry->value;
+			eb_post(&msg);
+		}
+	}
+}
+
+static void printEntry(const char* name, const RecEntry* entry) {
+	printf("  %s: %lu %u %u %d\n", name, (unsigned long) entry->ms, entry->type, entry->sourceId, entry->value);
+}
+
+/** Kinds of entries compared separately in mid-run trace. */
+enum class Kind {
+	ALL, TEMP, EVENT
+};
+
+static boolean isKind(const RecEntry* entry, Kind kind) {
+	if (kind == Kind::ALL) {
+		return true;
+	}
+	if (entry->type == REC_TEMP) {
+		return kind == Kind::TEMP;
+	}
+	return kind == Kind::EVENT && entry->type != static_cast<uint8_t>(BusEvent::RELAY_ON)
+			&& entry->type != static_cast<uint8_t>(BusEvent::RELAY_OFF);
+}
+
+/*
+ * Compares entries of given #kind recorded at #fromMs or later. Entry recorded during replay can be up to #lagMs late.
+ * Returns amount of mismatches.
+ */
+static uint32_t compare(Kind kind, uint32_t fromMs, uint32_t lagMs) {
+	std::vector<const RecEntry*> expected;
+	for (size_t idx = 0; idx < trace.size(); idx++) {
+		if (trace[idx].ms >= fromMs && isKind(&trace[idx], kind)) {
+			expected.push_back(&trace[idx]);
+		}
+	}
+	std::vector<const RecEntry*> replayed;
+	uint32_t replayFromMs = expected.empty() ? fromMs : expected.front()->ms;
+	for (uint16_t idx = 0; idx < rec_size(); idx++) {
+		const RecEntry* entry = rec_get(idx);
+		if (entry->ms >= replayFromMs && isKind(entry, kind)) {
+			replayed.push_back(entry);
+		}
+	}
+
+	uint32_t mismatches = 0;
+	for (size_t idx = 0; idx < max(expected.size(), replayed.size()); idx++) {
+		if (idx < expected.size() && idx < replayed.size()) {
+			const RecEntry* e1 = expected[idx];
+			const RecEntry* e2 = replayed[idx];
+			if (e1->type == e2->type && e1->sourceId == e2->sourceId && e1->value == e2->value && e2->ms >= e1->ms
+					&& e2->ms - e1->ms <= lagMs) {
+				continue;
+			}
+		}
+		if (mismatches++ == 0) {
+			printf("first mismatch at entry %lu\n", (unsigned long) idx);
+			if (idx < expected.size()) {
+				printEntry("trace ", expected[idx]);
+			}
+			if (idx < replayed.size()) {
+				printEntry("replay", replayed[idx]);
+			}
+		}
+	}
+	return mismatches;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2 || !readTrace(argv[1])) {
+		printf("Usage: thermostat_replay <trace> [us per loop]\n");
+		return 2;
+	}
+	uint32_t usPerLoop = argc > 2 ? strtoul(argv[2], NULL, 10) : 10;
+	if (trace.empty()) {
+		printf("trace is empty\n");
+		return 2;
+	}
+	boolean midRun = traceTotal > trace.size();
+
+	auto start = std::chrono::steady_clock::now();
+	host_reset();
+	host_onWakeUp(applyInputs);
+	if (midRun) {
+		for (size_t idx = 0; idx < trace.size(); idx++) {
+			if (trace[idx].type == REC_TEMP) {
+				host_setTempC((float) trace[idx].value / TEMP_UNIT);
+				break;
+			}
+		}
+	} else {
+		applyInputs();
+	}
+	setup();
+	for (size_t idx = 0; idx < trace.size(); idx++) {
+		if (trace[idx].type == REC_BOOT && trace[idx].ms > millis()) {
+			host_advanceMs(trace[idx].ms - millis());
+			break;
+		}
+	}
+
+	uint32_t endMs = trace.back().ms;
+	uint32_t loops = 0;
+	while (millis() <= endMs) {
+		applyInputs();
+		loop();
+		host_advanceUs(usPerLoop);
+		loops++;
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	uint32_t mismatches;
+	if (midRun) {
+		uint32_t fromMs = trace.front().ms + WARM_UP_MS;
+		mismatches = compare(Kind::EVENT, fromMs, 0) + compare(Kind::TEMP, fromMs, TS_PROBE_MAX_MS);
+	} else {
+		mismatches = compare(Kind::ALL, 0, 0);
+	}
+
+	double wallNs = std::chrono::duration<double, std::nano>(end - start).count();
+	printf("entries:         %lu of %lu\n", (unsigned long) trace.size(), (unsigned long) traceTotal);
+	printf("mismatches:      %lu\n", (unsigned long) mismatches);
+	printf("loops:           %lu\n", (unsigned long) loops);
+	printf("simulated time:  %.3f s\n", host_ns() / 1e9);
+	printf("wall time:       %.3f s\n", wallNs / 1e9);
+	return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Arduino.h"
+#include "Host.h"
+#include "Config.h"
+#include "Storage.h"
+
+/*
+ * Runs Storage operations on simulated EEPROM with full history and reports for each one: virtual time, which is
+ * mostly EEPROM write latency, amount of physically written and of read bytes. Then simulates given amount of years
+ * of the thermostat: a day entry each day, a week entry each week and a checkpoint each hour, and reports wear of the
+ * most written cell.
+ *
+ * Fails when the most written cell would not last #MIN_YEARS.
+ *
+ * Usage: storage_bench [years]
+ *
+ * storage_bench_mega is the same on 4 KB of EEPROM, with a year of days.
+ */
+
+const static uint32_t MIN_YEARS = 10;
+const static uint16_t RUNS = 500;
+
+static Temp temp = { 0, 0, 0, 0 };
+static StatsCheckpoint cp = { { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } };
+static Storage* storage;
+
+/* Changes data between runs as real statistics would, so that not every byte is different. */
+static void nextData(uint32_t run) {
+	temp.avg = temp_deg(20) + run % 50;
+	temp.min = temp.avg - run % 7;
+	temp.max = temp.avg + run % 11;
+	cp.day.sum += temp.avg;
+	cp.day.count = run % 24;
+	cp.day.elapsedMs = cp.day.count * ST_HOUR_MS;
+	cp.week.sum += temp.avg;
+	cp.week.count = run % 7;
+}
+
+static void opDayStore(uint32_t) {
+	storage->dh_store(&temp);
+}
+
+static void opWeekStore(uint32_t) {
+	storage->wh_store(&temp);
+}
+
+static void opCheckpoint(uint32_t) {
+	storage->cp_store(&cp);
+}
+
+/* Clear of empty storage writes nothing, it's measured with a day and a week in it. */
+static void prepareClear(uint32_t) {
+	storage->dh_store(&temp);
+	storage->wh_store(&temp);
+}
+
+static void opClear(uint32_t) {
+	storage->dh_clear();
+}
+
+static void opBoot(uint32_t) {
+	Storage rebooted;
+}
+
+static void opDayRead(uint32_t run) {
+	Temp read;
+	storage->dh_read(&read, run % storage->dh_readDays());
+}
+
+/* User going one day back and forth on the display, a bit further each time. */
+static void opDayPage(uint32_t run) {
+	Temp read;
+	uint16_t dIdx = run % (storage->dh_readDays() - 1);
+	storage->dh_read(&read, dIdx);
+	storage->dh_read(&read, dIdx + 1);
+	storage->dh_read(&read, dIdx);
+}
+
+static void opDaysReadAll(uint32_t) {
+	Temp read;
+	for (uint16_t dIdx = 0; dIdx < storage->dh_readDays(); dIdx++) {
+		storage->dh_read(&read, dIdx);
+	}
+}
+
+static void fill() {
+	for (uint16_t i = 0; i < Storage::DAY_CAPACITY; i++) {
+		storage->dh_store(&temp);
+		storage->wh_store(&temp);
+	}
+	ee_flush();
+}
+
+static void bench(const char* name, void (*op)(uint32_t), void (*prepare)(uint32_t) = NULL) {
+	uint64_t ns = 0;
+	uint32_t writes = 0;
+	uint32_t reads = 0;
+	for (uint32_t run = 0; run < RUNS; run++) {
+		nextData(run);
+		if (prepare != NULL) {
+			prepare(run);
+			ee_flush();
+		}
+		host_eepromResetWear();
+		uint64_t startNs = host_ns();
+		op(run);
+		ee_flush();
+		ns += host_ns() - startNs;
+		writes += host_eepromWrites();
+		reads += host_eepromReads();
+	}
+	printf("%-12s %8.3f ms %8.2f %8.1f\n", name, ns / 1e6 / RUNS, (double) writes / RUNS, (double) reads / RUNS);
+}
+
+int main(int argc, char** argv) {
+	uint32_t years = argc > 1 ? strtoul(argv[1], NULL, 10) : 1;
+	storage = new Storage();
+	storage->dh_clear();
+	fill();
+
+	printf("EEPROM:      %u bytes\n", E2END + 1);
+	printf("days:        %u\n", storage->dh_readDays());
+	printf("operation      time/op   writes    reads\n");
+	bench("dh_store", opDayStore);
+	bench("wh_store", opWeekStore);
+	bench("cp_store", opCheckpoint);
+	bench("dh_clear", opClear, prepareClear);
+	fill();
+	bench("boot", opBoot);
+	bench("dh_read", opDayRead);
+	bench("dh_page", opDayPage);
+	bench("dh_read all", opDaysReadAll);
+
+	host_eepromResetWear();
+	for (uint32_t hour = 0; hour < years * 365 * 24; hour++) {
+		nextData(hour);
+		if (hour % 24 == 23) {
+			storage->dh_store(&temp);
+		}
+		if (hour % (24 * 7) == 24 * 7 - 1) {
+			storage->wh_store(&temp);
+		}
+		storage->cp_store(&cp);
+		ee_flush();
+	}
+	uint16_t maxIdx = host_eepromMaxWearIdx();
+	uint32_t maxWear = host_eepromWear(maxIdx);
+	double lifeYears = maxWear == 0 ? 1e9 : (double) HOST_EEPROM_ENDURANCE * years / maxWear;
+	printf("years:       %lu\n", (unsigned long) years);
+	printf("writes:      %lu\n", (unsigned long) host_eepromWrites());
+	printf("max wear:    %lu (cell %u)\n", (unsigned long) maxWear, maxIdx);
+	printf("life years:  %.1f\n", lifeYears);
+	return lifeYears >= MIN_YEARS ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Arduino.h"
+#include "Host.h"
+#include "Config.h"
+#include "Storage.h"
+
+/*
+ * Cuts power at every EEPROM write of a Storage operation, reboots and checks that storage holds either the state
+ * before the operation or after it: no torn entry is ever read, at most the oldest entry gets lost. Operations: format
+ * of EEPROM with foreign content, storing a day into partially filled and into full history, checkpoint and clear.
+ *
+ * Prints failures and amount of checked cuts, fails on first broken state.
+ *
+ * Usage: storage_fuzz
+ */
+
+const static uint16_t CP_MARK = 0x5A00;
+
+static uint16_t stored;
+static uint32_t failures = 0;
+
+static void fail(const char* name, uint32_t cut, const char* msg) {
+	if (failures++ < 10) {
+		printf("%s cut %lu: %s\n", name, (unsigned long) cut, msg);
+	}
+}
+
+static Temp dayTemp(uint16_t val) {
+	Temp temp = { (temp_t) val, (temp_t) -val, (temp_t) (2 * val), 0 };
+	return temp;
+}
+
+static StatsCheckpoint checkpoint(uint16_t val) {
+	StatsCheckpoint cp = { { CP_MARK + val, val, (temp_t) -val, (temp_t) val, (uint32_t) val * 1000 }, { val, 1, 0, 0, 0 } };
+	return cp;
+}
+
+static boolean sameTier(const TierCheckpoint* t1, const TierCheckpoint* t2) {
+	return t1->sum == t2->sum && t1->count == t2->count && t1->min == t2->min && t1->max == t2->max
+			&& t1->elapsedMs == t2->elapsedMs;
+}
+
+/* Field by field, padding of the struct is not stored. */
+static boolean sameCheckpoint(const StatsCheckpoint* cp1, const StatsCheckpoint* cp2) {
+	return sameTier(&cp1->day, &cp2->day) && sameTier(&cp1->week, &cp2->week);
+}
+
+/* Fresh EEPROM with given amount of days and checkpoints. */
+static void prepare(uint16_t days, uint16_t checkpoints) {
+	host_eepromPowerOn();
+	EEPROM.erase();
+	Storage storage;
+	for (uint16_t day = 0; day < days; day++) {
+		Temp temp = dayTemp(day);
+		storage.dh_store(&temp);
+	}
+	for (uint16_t cpIdx = 1; cpIdx <= checkpoints; cpIdx++) {
+		StatsCheckpoint cp = checkpoint(cpIdx);
+		storage.cp_store(&cp);
+	}
+	ee_flush();
+	stored = days;
+}
+
+/* Days have to be consecutive values, newest first, and the newest one is given. */
+static boolean checkDays(Storage* storage, uint16_t newest) {
+	for (uint16_t dIdx = 0; dIdx < storage->dh_readDays(); dIdx++) {
+		Temp temp;
+		storage->dh_read(&temp, dIdx);
+		Temp expected = dayTemp(newest - dIdx);
+		if (temp.avg != expected.avg || temp.min != expected.min || temp.max != expected.max) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void checkStore(const char* name, uint32_t cut, boolean done) {
+	Storage storage;
+	uint16_t size = storage.dh_readDays();
+	uint16_t before = min(stored, Storage::DAY_CAPACITY);
+	uint16_t after = min((uint16_t) (stored + 1), Storage::DAY_CAPACITY);
+	if (size == after && checkDays(&storage, stored)) {
+		return;
+	}
+	if (done) {
+		fail(name, cut, "stored day lost");
+	} else if ((size == before || (size + 1 == before && before == Storage::DAY_CAPACITY))
+			&& checkDays(&storage, stored - 1)) {
+		return;
+	} else {
+		fail(name, cut, "broken days");
+	}
+}
+
+static void checkCheckpoint(const char* name, uint32_t cut, boolean done) {
+	Storage storage;
+	StatsCheckpoint cp;
+	if (!storage.cp_load(&cp)) {
+		fail(name, cut, "checkpoint lost");
+		return;
+	}
+	StatsCheckpoint before = checkpoint(2), after = checkpoint(3);
+	if (sameCheckpoint(&cp, &after)) {
+		return;
+	}
+	if (done || !sameCheckpoint(&cp, &before)) {
+		fail(name, cut, "broken checkpoint");
+	}
+}
+
+static void checkClear(const char* name, uint32_t cut, boolean done) {
+	Storage storage;
+	StatsCheckpoint cp;
+	StatsCheckpoint before = checkpoint(1);
+	if (storage.dh_readDays() > stored || !checkDays(&storage, stored - 1)) {
+		fail(name, cut, "broken days");
+	}
+	if (storage.cp_load(&cp) && !sameCheckpoint(&cp, &before)) {
+		fail(name, cut, "broken checkpoint");
+	}
+	if (done && (storage.dh_readDays() != 0 || storage.cp_load(&cp))) {
+		fail(name, cut, "not cleared");
+	}
+}
+
+/* Torn format gets repeated on the next boot, complete one leaves nothing to be written. */
+static void checkFormat(const char* name, uint32_t cut, boolean done) {
+	host_eepromResetWear();
+	Storage storage;
+	ee_flush();
+	if (done && host_eepromWrites() != 0) {
+		fail(name, cut, "format not complete");
+	}
+	StatsCheckpoint cp;
+	if (storage.dh_readDays() != 0 || storage.wh_readWeeks() != 0 || storage.cp_load(&cp)) {
+		fail(name, cut, "not empty");
+		return;
+	}
+	Temp temp = dayTemp(7);
+	storage.dh_store(&temp);
+	Storage rebooted;
+	if (rebooted.dh_readDays() != 1 || !checkDays(&rebooted, 7)) {
+		fail(name, cut, "not usable");
+	}
+}
+
+/* Runs given operation once to count its writes, and then once for each write with power cut before it. */
+static uint32_t fuzz(const char* name, void (*prep)(), void (*op)(), void (*check)(const char*, uint32_t, boolean)) {
+	prep();
+	host_eepromResetWear();
+	op();
+	ee_flush();
+	uint32_t writes = host_eepromWrites();
+
+	for (uint32_t cut = 0; cut <= writes; cut++) {
+		prep();
+		host_eepromPowerCut(cut);
+		op();
+		ee_flush();
+		host_eepromPowerOn();
+		check(name, cut, cut == writes);
+	}
+	printf("%-12s %5lu cuts\n", name, (unsigned long) writes + 1);
+	return writes + 1;
+}
+
+static void prepFormat() {
+	host_eepromPowerOn();
+	EEPROM.erase();
+	uint32_t seed = 1;
+	for (uint16_t eIdx = 0; eIdx <= E2END; eIdx++) {
+		seed = seed * 1103515245 + 12345;
+		EEPROM.write(eIdx, seed >> 16);
+	}
+}
+
+static void opFormat() {
+	Storage storage;
+}
+
+static void prepPartial() {
+	prepare(5, 0);
+}
+
+static void prepFull() {
+	prepare(Storage::DAY_CAPACITY + 3, 0);
+}
+
+static void opStore() {
+	Storage storage;
+	Temp temp = dayTemp(stored);
+	storage.dh_store(&temp);
+}
+
+static void prepCheckpoint() {
+	prepare(3, 2);
+}
+
+static void opCheckpoint() {
+	Storage storage;
+	StatsCheckpoint cp = checkpoint(3);
+	storage.cp_store(&cp);
+}
+
+static void prepClear() {
+	prepare(Storage::DAY_CAPACITY / 2, 1);
+}
+
+static void opClear() {
+	Storage storage;
+	storage.dh_clear();
+}
+
+int main() {
+	uint32_t cuts = 0;
+	cuts += fuzz("format", prepFormat, opFormat, checkFormat);
+	cuts += fuzz("store", prepPartial, opStore, checkStore);
+	cuts += fuzz("store full", prepFull, opStore, checkStore);
+	cuts += fuzz("checkpoint", prepCheckpoint, opCheckpoint, checkCheckpoint);
+	cuts += fuzz("clear", prepClear, opClear, checkClear);
+	printf("cuts:     %lu\n", (unsigned long) cuts);
+	printf("failures: %lu\n", (unsigned long) failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Arduino.h"
+#include "Config.h"
+#include "Recorder.h"
+#include "TempLog.h"
+
+/*
+ * Feeds minute samples into TempLog, decodes them back and reports how much history fits and how many bytes each
+ * sample takes. Samples come from temperatures in a recorder trace (see Recorder.h), resampled to one per minute, or
+ * from a synthetic attic: daily sine, fan switching every few hours and noise.
+ *
+ * Fails when decoded samples differ from the newest samples that have been added.
+ *
+ * Usage: templog_bench [trace]
+ */
+
+static void traceSamples(FILE* file, std::vector<temp_t>& samples) {
+	char line[128];
+	unsigned long ms, type, src;
+	long value;
+	uint32_t nextMs = 0;
+	temp_t temp = 0;
+	boolean found = false;
+	while (fgets(line, sizeof(line), file)) {
+		if (sscanf(line, "RC %lu %lu %lu %ld", &ms, &type, &src, &value) != 4 || type != REC_TEMP) {
+			continue;
+		}
+		while (found && nextMs <= ms) {
+			samples.push_back(temp);
+			nextMs += ST_MINUTE_MS;
+		}
+		if (!found) {
+			nextMs = ms;
+			found = true;
+		}
+		temp = value;
+	}
+	if (found) {
+		samples.push_back(temp);
+	}
+}
+
+static void syntheticSamples(std::vector<temp_t>& samples) {
+	uint32_t seed = 1;
+	const uint32_t minutes = 3 * 24 * 60;
+	for (uint32_t mm = 0; mm < minutes; mm++) {
+		seed = seed * 1103515245 + 12345;
+		double temp = 250 + 100 * sin(mm * 2 * M_PI / (24 * 60));
+		if ((mm / 180) % 2 == 1) {
+			temp -= 30 * (1 - exp(-(mm % 180) / 20.0)); // fan running
+		}
+		samples.push_back(lround(temp) + (int32_t) ((seed >> 16) % 3) - 1);
+	}
+}
+
+int main(int argc, char** argv) {
+	std::vector<temp_t> samples;
+	if (argc > 1) {
+		FILE* file = fopen(argv[1], "r");
+		if (file == NULL) {
+			printf("Cannot open %s\n", argv[1]);
+			return 1;
+		}
+		traceSamples(file, samples);
+		fclose(file);
+	} else {
+		syntheticSamples(samples);
+	}
+
+	TempLog tempLog;
+	for (temp_t temp : samples) {
+		tempLog.add(temp);
+	}
+
+	uint16_t size = tempLog.size();
+	uint32_t errors = 0;
+	TempLog::Reader reader(&tempLog);
+	for (size_t i = samples.size() - size; i < samples.size(); i++) {
+		if (!reader.hasNext() || reader.next() != samples[i]) {
+			errors++;
+		}
+	}
+
+	uint16_t bytes = tempLog.bytes();
+	printf("samples added:    %lu\n", (unsigned long) samples.size());
+	printf("samples held:     %u (%.1f h)\n", size, size / 60.0);
+	printf("bytes used:       %u of %lu\n", bytes, (unsigned long) sizeof(TempLog));
+	printf("bytes per sample: %.3f\n", size == 0 ? 0 : (double) bytes / size);
+	printf("compression:      %.2f\n", bytes == 0 ? 0 : 2.0 * size / bytes);
+	printf("errors:           %lu\n", (unsigned long) errors);
+	return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+
+#include "Arduino.h"
+#include "Host.h"
+#include "avr/sleep.h"
+
+const static uint8_t PINS_MAX = 70;
+
+static uint64_t clockNs = 0;
+static uint64_t sleepNs = 0;
+static void (*wakeUpHook)() = NULL;
+static std::chrono::steady_clock::time_point resetTime = std::chrono::steady_clock::now();
+static uint8_t pins[PINS_MAX];
+static void (*isrs[PINS_MAX])();
+
+HardwareSerial Serial;
+
+// ############### Host ###############
+void host_reset() {
+	clockNs = 0;
+	sleepNs = 0;
+	wakeUpHook = NULL;
+	resetTime = std::chrono::steady_clock::now();
+	memset(pins, 0, sizeof(pins));
+	memset(isrs, 0, sizeof(isrs));
+}
+
+void host_advanceNs(uint64_t ns) {
+	clockNs += ns;
+}
+
+void host_advanceUs(uint32_t us) {
+	clockNs += us * 1000ULL;
+}
+
+void host_advanceMs(uint32_t ms) {
+	clockNs += ms * 1000000ULL;
+}
+
+uint64_t host_ns() {
+	return clockNs;
+}
+
+uint64_t host_hrNs() {
+	return clockNs + std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - resetTime).count();
+}
+
+void host_onWakeUp(void (*hook)()) {
+	wakeUpHook = hook;
+}
+
+uint64_t host_sleepNs() {
+	return sleepNs;
+}
+
+void host_interrupt(uint8_t pin) {
+	if (pin < PINS_MAX && isrs[pin] != NULL) {
+		isrs[pin]();
+	}
+}
+
+uint8_t host_pin(uint8_t pin) {
+	return pin < PINS_MAX ? pins[pin] : LOW;
+}
+
+// ############### Time ###############
+uint32_t millis() {
+	return (uint32_t) (clockNs / 1000000ULL);
+}
+
+uint32_t micros() {
+	return (uint32_t) (clockNs / 1000ULL);
+}
+
+void delay(uint32_t ms) {
+	host_advanceMs(ms);
+}
+
+void delayMicroseconds(uint16_t us) {
+	host_advanceUs(us);
+}
+
+// ############### Sleep ###############
+void set_sleep_mode(uint8_t mode) {
+}
+
+void sleep_enable() {
+}
+
+void sleep_disable() {
+}
+
+void sleep_cpu() {
+	uint64_t wakeNs = (clockNs / 1000000ULL + 1) * 1000000ULL;
+	sleepNs += wakeNs - clockNs;
+	clockNs = wakeNs;
+	if (wakeUpHook != NULL) {
+		wakeUpHook();
+	}
+}
+
+// ############### Pins & interrupts ###############
+void pinMode(uint8_t pin, uint8_t mode) {
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+	if (pin < PINS_MAX) {
+		pins[pin] = val;
+	}
+}
+
+int digitalRead(uint8_t pin) {
+	return host_pin(pin);
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*isr)(), int mode) {
+	if (interruptNum < PINS_MAX) {
+		isrs[interruptNum] = isr;
+	}
+}
+
+void detachInterrupt(uint8_t interruptNum) {
+	if (interruptNum < PINS_MAX) {
+		isrs[interruptNum] = NULL;
+	}
+}
+
+void interrupts() {
+}
+
+void noInterrupts() {
+}
+
+// ############### Print ###############
+size_t Print::write(const char *str) {
+	size_t n = 0;
+	while (*str) {
+		n += write((uint8_t) *str++);
+	}
+	return n;
+}
+
+size_t Print::print(const __FlashStringHelper *ifsh) {
+	return write(reinterpret_cast<const char *>(ifsh));
+}
+
+size_t Print::print(const char str[]) {
+	return write(str);
+}
+
+size_t Print::print(char c) {
+	return write((uint8_t) c);
+}
+
+size_t Print::print(int n) {
+	return print((long) n);
+}
+
+size_t Print::print(unsigned int n) {
+	return print((unsigned long) n);
+}
+
+size_t Print::print(long n) {
+	char buf[24];
+	snprintf(buf, sizeof(buf), "%ld", n);
+	return write(buf);
+}
+
+size_t Print::print(unsigned long n) {
+	char buf[24];
+	snprintf(buf, sizeof(buf), "%lu", n);
+	return write(buf);
+}
+
+size_t Print::print(double n) {
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%.2f", n);
+	return write(buf);
+}
+
+size_t Print::println() {
+	return write('\r') + write('\n');
+}
+
+// ############### Serial ###############
+void HardwareSerial::begin(uint32_t speed) {
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+	if (c != '\r') {
+		putchar(c);
+	}
+	return 1;
+}
+
+int HardwareSerial::available() {
+	return 0;
+}
+
+int HardwareSerial::read() {
+	return -1;
+}
@@ -0,0 +1,135 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ARDUINO_H_
+#define ARDUINO_H_
+
+/*
+ * Host stand-in for the Arduino core. It provides just enough of the AVR API to compile the firmware from src/ on
+ * a desktop machine. Time is virtual: millis() and micros() only move forward when Host.h advances the clock, or
+ * when a simulated peripheral blocks (for example a DS18B20 conversion).
+ */
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <type_traits>
+
+#include "binary.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+// ############### Program memory ###############
+#define PROGMEM
+#define PSTR(s) (s)
+typedef const char* PGM_P;
+#define pgm_read_byte(addr) (*(const unsigned char *)(addr))
+#define pgm_read_word(addr) (*(const unsigned short *)(addr))
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define vsnprintf_P vsnprintf
+#define sprintf_P sprintf
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+// ############### Time ###############
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint16_t us);
+
+// ############### Pins & interrupts ###############
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t interruptNum, void (*isr)(), int mode);
+void detachInterrupt(uint8_t interruptNum);
+void interrupts();
+void noInterrupts();
+#define cli() noInterrupts()
+#define sei() interrupts()
+
+// ############### Math ###############
+template<class T, class U>
+inline typename std::common_type<T, U>::type min(T a, U b) {
+	return a < b ? a : b;
+}
+
+template<class T, class U>
+inline typename std::common_type<T, U>::type max(T a, U b) {
+	return a > b ? a : b;
+}
+
+template<class T, class L, class H>
+inline T constrain(T amt, L low, H high) {
+	return amt < low ? low : (amt > high ? high : amt);
+}
+
+// ############### Print & Serial ###############
+class Print {
+public:
+	virtual ~Print() {
+	}
+	virtual size_t write(uint8_t c) = 0;
+	size_t write(const char *str);
+	size_t print(const __FlashStringHelper *ifsh);
+	size_t print(const char str[]);
+	size_t print(char c);
+	size_t print(int n);
+	size_t print(unsigned int n);
+	size_t print(long n);
+	size_t print(unsigned long n);
+	size_t print(double n);
+	size_t println();
+	template<class T>
+	size_t println(T val) {
+		return print(val) + println();
+	}
+};
+
+class HardwareSerial: public Print {
+public:
+	using Print::write;
+	void begin(uint32_t speed);
+	size_t write(uint8_t c);
+	int available();
+	int read();
+	operator bool() {
+		return true;
+	}
+};
+
+extern HardwareSerial Serial;
+
+#endif /* ARDUINO_H_ */
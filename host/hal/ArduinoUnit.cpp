@@ -0,0 +1,69 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ArduinoUnit.h"
+
+Test* Test::root = NULL;
+Test* Test::current = NULL;
+boolean Test::failedCurrent = false;
+uint16_t Test::failedCnt = 0;
+uint16_t Test::passedCnt = 0;
+
+Test::Test(const char* name) :
+		name(name), next(NULL) {
+
+	// keep list sorted by name
+	Test** pos = &root;
+	while (*pos != NULL && strcmp((*pos)->name, name) < 0) {
+		pos = &(*pos)->next;
+	}
+	next = *pos;
+	*pos = this;
+}
+
+Test::~Test() {
+}
+
+void Test::run() {
+	while (root != NULL) {
+		current = root;
+		root = root->next;
+		failedCurrent = false;
+		current->once();
+		if (failedCurrent) {
+			failedCnt++;
+			printf("Test %s failed.\n", current->name);
+		} else {
+			passedCnt++;
+			printf("Test %s passed.\n", current->name);
+		}
+	}
+	current = NULL;
+	printf("Test summary: %u passed, %u failed, out of %u test(s).\n", passedCnt, failedCnt, passedCnt + failedCnt);
+}
+
+uint16_t Test::failed() {
+	return failedCnt;
+}
+
+void Test::fail(const char* file, int line, const char* expr) {
+	failedCurrent = true;
+	printf("Assertion failed: (%s), file %s, line %d.\n", expr, file, line);
+}
+
+boolean Test::currentFailed() {
+	return failedCurrent;
+}
@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ARDUINOUNIT_H_
+#define ARDUINOUNIT_H_
+
+#include "Arduino.h"
+
+/**
+ * Host stand-in for ArduinoUnit. Tests are registered by #test(name) and executed in alphabetical order - the same
+ * as on the board. A failed assertion stops the current test.
+ */
+class Test {
+public:
+	Test(const char* name);
+	virtual ~Test();
+	virtual void once() = 0;
+
+	/** Runs all tests that have not been executed yet. */
+	static void run();
+
+	/** Amount of failed tests, host runner uses it as exit code. */
+	static uint16_t failed();
+
+	static void fail(const char* file, int line, const char* expr);
+	static boolean currentFailed();
+
+private:
+	const char* name;
+	Test* next;
+	static Test* root;
+	static Test* current;
+	static boolean failedCurrent;
+	static uint16_t failedCnt;
+	static uint16_t passedCnt;
+};
+
+#define test(name) \
+	struct test_ ## name: Test { \
+		test_ ## name() : Test(#name) {} \
+		void once(); \
+	} test_ ## name ## _instance; \
+	void test_ ## name::once()
+
+#define ARDUINO_UNIT_ASSERT(cond, expr) \
+	do { \
+		if (!(cond)) { \
+			Test::fail(__FILE__, __LINE__, expr); \
+			return; \
+		} \
+	} while (0)
+
+#define assertEqual(a, b) ARDUINO_UNIT_ASSERT((a) == (b), #a " == " #b)
+#define assertNotEqual(a, b) ARDUINO_UNIT_ASSERT((a) != (b), #a " != " #b)
+#define assertLess(a, b) ARDUINO_UNIT_ASSERT((a) < (b), #a " < " #b)
+#define assertMore(a, b) ARDUINO_UNIT_ASSERT((a) > (b), #a " > " #b)
+#define assertLessOrEqual(a, b) ARDUINO_UNIT_ASSERT((a) <= (b), #a " <= " #b)
+#define assertMoreOrEqual(a, b) ARDUINO_UNIT_ASSERT((a) >= (b), #a " >= " #b)
+#define assertTrue(a) ARDUINO_UNIT_ASSERT((a), #a)
+#define assertFalse(a) ARDUINO_UNIT_ASSERT(!(a), "!" #a)
+
+#endif /* ARDUINOUNIT_H_ */
@@ -0,0 +1,118 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DallasTemperature.h"
+#include "Host.h"
+
+const static uint8_t SENSORS_MAX = 8;
+const static uint8_t FAMILY_DS18B20 = 0x28;
+static float simTempC[SENSORS_MAX] = { 20, 20, 20, 20, 20, 20, 20, 20 };
+static uint8_t sensors = 1;
+static uint32_t conversions = 0;
+static uint32_t searches = 0;
+
+void host_setTempC(float temp) {
+	simTempC[0] = temp;
+}
+
+void host_setSensorTempC(uint8_t idx, float temp) {
+	if (idx < SENSORS_MAX) {
+		simTempC[idx] = temp;
+	}
+}
+
+void host_setSensors(uint8_t amount) {
+	sensors = amount < SENSORS_MAX ? amount : SENSORS_MAX;
+}
+
+uint32_t host_conversions() {
+	return conversions;
+}
+
+uint32_t host_busSearches() {
+	return searches;
+}
+
+DallasTemperature::DallasTemperature(OneWire* oneWire) :
+		oneWire(oneWire), resolution(12), waitForConversion(true), requestMs(0) {
+}
+
+void DallasTemperature::begin() {
+}
+
+void DallasTemperature::requestTemperatures() {
+	requestMs = millis();
+	conversions++;
+	if (waitForConversion) {
+		delay(millisToWaitForConversion(resolution));
+	}
+}
+
+void DallasTemperature::setWaitForConversion(bool flag) {
+	waitForConversion = flag;
+}
+
+bool DallasTemperature::isConversionComplete() {
+	return millis() - requestMs >= millisToWaitForConversion(resolution);
+}
+
+uint8_t DallasTemperature::getDeviceCount() {
+	searches++;
+	return sensors;
+}
+
+bool DallasTemperature::getAddress(uint8_t* address, uint8_t idx) {
+	searches++;
+	if (idx >= sensors) {
+		return false;
+	}
+	memset(address, 0, sizeof(DeviceAddress));
+	address[0] = FAMILY_DS18B20;
+	address[1] = idx;
+	return true;
+}
+
+float DallasTemperature::getTempC(const uint8_t* address) {
+	uint8_t idx = address[1];
+	return address[0] == FAMILY_DS18B20 && idx < sensors ? simTempC[idx] : DEVICE_DISCONNECTED_C;
+}
+
+int32_t DallasTemperature::getTemp(const uint8_t* address) {
+	float tempC = getTempC(address);
+	return tempC == DEVICE_DISCONNECTED_C ? DEVICE_DISCONNECTED_RAW : lround(tempC * 128);
+}
+
+float DallasTemperature::getTempCByIndex(uint8_t idx) {
+	searches++;
+	return idx < sensors ? simTempC[idx] : DEVICE_DISCONNECTED_C;
+}
+
+uint8_t DallasTemperature::getResolution() {
+	return resolution;
+}
+
+uint16_t DallasTemperature::millisToWaitForConversion(uint8_t bitResolution) {
+	switch (bitResolution) {
+	case 9:
+		return 94;
+	case 10:
+		return 188;
+	case 11:
+		return 375;
+	default:
+		return 750;
+	}
+}
@@ -0,0 +1,58 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DALLASTEMPERATURE_H_
+#define DALLASTEMPERATURE_H_
+
+#include "Arduino.h"
+#include "OneWire.h"
+
+#define DEVICE_DISCONNECTED_C -127
+#define DEVICE_DISCONNECTED_RAW -7040
+
+typedef uint8_t DeviceAddress[8];
+
+/**
+ * Host stand-in for the DS18B20 driver. Temperature is set over host_setTempC(). Blocking calls advance the virtual
+ * clock by the time that real sensor needs for conversion, so that benchmarks see the same stalls as the board. Without
+ * waiting for conversion, it is complete after the same time on the virtual clock. Sensor n has address
+ * 28 n 0 0 0 0 0 0.
+ */
+class DallasTemperature {
+public:
+	DallasTemperature(OneWire* oneWire);
+	void begin();
+	void requestTemperatures();
+	void setWaitForConversion(bool flag);
+	bool isConversionComplete();
+	uint8_t getDeviceCount();
+	bool getAddress(uint8_t* address, uint8_t idx);
+	float getTempC(const uint8_t* address);
+
+	/** Temperature in 1/128 of degree Celsius. */
+	int32_t getTemp(const uint8_t* address);
+	float getTempCByIndex(uint8_t idx);
+	uint8_t getResolution();
+	uint16_t millisToWaitForConversion(uint8_t bitResolution);
+
+private:
+	OneWire* oneWire;
+	uint8_t resolution;
+	bool waitForConversion;
+	uint32_t requestMs;
+};
+
+#endif /* DALLASTEMPERATURE_H_ */
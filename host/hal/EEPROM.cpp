@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "EEPROM.h"
+#include "Host.h"
+
+EEPROMClass EEPROM;
+
+EEPROMClass::EEPROMClass() :
+		writes(0), reads(0), endurance(HOST_EEPROM_ENDURANCE), powerWrites(-1) {
+	erase();
+	memset(wear, 0, sizeof(wear));
+}
+
+uint8_t EEPROMClass::read(int idx) {
+	host_advanceNs(HOST_EEPROM_READ_NS);
+	reads++;
+	return cells[idx];
+}
+
+void EEPROMClass::write(int idx, uint8_t val) {
+	if (powerWrites == 0) {
+		return;
+	}
+	if (powerWrites > 0 && --powerWrites == 0) {
+		cells[idx] = 0xFF;
+		return;
+	}
+	host_advanceUs(HOST_EEPROM_WRITE_US);
+	writes++;
+	if (++wear[idx] <= endurance) {
+		cells[idx] = val;
+	}
+}
+
+void EEPROMClass::update(int idx, uint8_t val) {
+	if (cells[idx] != val) {
+		write(idx, val);
+	}
+}
+
+uint16_t EEPROMClass::length() {
+	return E2END + 1;
+}
+
+void EEPROMClass::erase() {
+	memset(cells, 0xFF, sizeof(cells));
+}
+
+void host_setEepromEndurance(uint32_t writes) {
+	EEPROM.endurance = writes;
+}
+
+uint32_t host_eepromWear(uint16_t idx) {
+	return EEPROM.wear[idx];
+}
+
+uint32_t host_eepromWrites() {
+	return EEPROM.writes;
+}
+
+void host_eepromPowerCut(uint32_t writes) {
+	EEPROM.powerWrites = writes + 1;
+}
+
+void host_eepromPowerOn() {
+	EEPROM.powerWrites = -1;
+}
+
+uint32_t host_eepromReads() {
+	return EEPROM.reads;
+}
+
+uint16_t host_eepromMaxWearIdx() {
+	uint16_t maxIdx = 0;
+	for (uint16_t idx = 1; idx <= E2END; idx++) {
+		if (EEPROM.wear[idx] > EEPROM.wear[maxIdx]) {
+			maxIdx = idx;
+		}
+	}
+	return maxIdx;
+}
+
+void host_eepromResetWear() {
+	memset(EEPROM.wear, 0, sizeof(EEPROM.wear));
+	EEPROM.writes = 0;
+	EEPROM.reads = 0;
+}
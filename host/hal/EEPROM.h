@@ -0,0 +1,60 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+#include "Arduino.h"
+
+/* Last EEPROM address, ATmega328P has 1 KB. Define it on the command line to simulate other boards. */
+#ifndef E2END
+#define E2END 0x3FF
+#endif
+
+/** Host stand-in for the Arduino EEPROM library, backed by RAM and erased (0xFF) on start. */
+class EEPROMClass {
+public:
+	EEPROMClass();
+	uint8_t read(int idx);
+	void write(int idx, uint8_t val);
+	void update(int idx, uint8_t val);
+	uint16_t length();
+
+	/** Sets all cells to 0xFF. */
+	void erase();
+
+private:
+	uint8_t cells[E2END + 1];
+	uint32_t wear[E2END + 1];
+	uint32_t writes;
+	uint32_t reads;
+	uint32_t endurance;
+
+	/* writes until power cut, -1 - no cut, 0 - power is down. */
+	int32_t powerWrites;
+	friend uint32_t host_eepromWear(uint16_t idx);
+	friend uint32_t host_eepromWrites();
+	friend uint32_t host_eepromReads();
+	friend uint16_t host_eepromMaxWearIdx();
+	friend void host_eepromResetWear();
+	friend void host_setEepromEndurance(uint32_t writes);
+	friend void host_eepromPowerCut(uint32_t writes);
+	friend void host_eepromPowerOn();
+};
+
+extern EEPROMClass EEPROM;
+
+#endif /* EEPROM_H_ */
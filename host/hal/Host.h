@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HOST_H_
+#define HOST_H_
+
+#include "Arduino.h"
+
+/*
+ * Controls for the simulated board. Only HOST_BUILD sections of src/ include this file - it's meant for host runners, tests and
+ * benchmarks that drive the firmware.
+ */
+
+/** Resets virtual clock, pins and attached interrupts. */
+void host_reset();
+
+/** Moves virtual clock forward, millis() and micros() are derived from it. */
+void host_advanceNs(uint64_t ns);
+void host_advanceUs(uint32_t us);
+void host_advanceMs(uint32_t ms);
+uint64_t host_ns();
+
+/** Virtual clock plus real time elapsed since host_reset(), used by the profiler to measure execution. */
+uint64_t host_hrNs();
+
+/** Part of the virtual clock spent in sleep_cpu(). */
+uint64_t host_sleepNs();
+
+/** #hook is called by sleep_cpu() after each wake up, as if it was timer interrupt. NULL removes it. */
+void host_onWakeUp(void (*hook)());
+
+/** Executes interrupt handler attached to given pin, as if the button has been pressed. */
+void host_interrupt(uint8_t pin);
+
+/** Last value written to given pin. */
+uint8_t host_pin(uint8_t pin);
+
+/** Temperature returned by the first simulated DS18B20 sensor. */
+void host_setTempC(float temp);
+
+/** Temperature returned by given simulated sensor. */
+void host_setSensorTempC(uint8_t idx, float temp);
+
+/** Amount of sensors on the simulated OneWire bus, 1 by default. */
+void host_setSensors(uint8_t amount);
+
+/** Amount of conversions requested from the simulated sensors. */
+uint32_t host_conversions();
+
+/** Amount of bus searches: device count, address or temperature looked up by index. */
+uint32_t host_busSearches();
+
+/**
+ * Simulated EEPROM: each write of a cell takes #HOST_EEPROM_WRITE_US of virtual time, as erase and write on ATmega328P
+ * does, read takes #HOST_EEPROM_READ_NS - 4 cycles of halted CPU and the call of EEPROM.read(). Cell written more
+ * than #host_setEepromEndurance() times keeps its old content.
+ */
+const static uint32_t HOST_EEPROM_WRITE_US = 3400;
+const static uint32_t HOST_EEPROM_READ_NS = 750;
+
+/** Write/erase cycles guaranteed by ATmega328P datasheet, default endurance of each cell. */
+const static uint32_t HOST_EEPROM_ENDURANCE = 100000;
+void host_setEepromEndurance(uint32_t writes);
+
+/** Amount of writes of given cell, and of all cells since the last host_eepromResetWear(). */
+uint32_t host_eepromWear(uint16_t idx);
+uint32_t host_eepromWrites();
+
+/** Amount of cells read since the last host_eepromResetWear(). */
+uint32_t host_eepromReads();
+
+/**
+ * Power goes down after given amount of writes: the next write leaves its cell erased (0xFF), and nothing is written
+ * until #host_eepromPowerOn().
+ */
+void host_eepromPowerCut(uint32_t writes);
+void host_eepromPowerOn();
+
+/** The most written cell. */
+uint16_t host_eepromMaxWearIdx();
+void host_eepromResetWear();
+
+#endif /* HOST_H_ */
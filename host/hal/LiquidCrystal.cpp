@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "LiquidCrystal.h"
+
+LiquidCrystal::LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3) :
+		col(0), row(0) {
+	clear();
+}
+
+void LiquidCrystal::begin(uint8_t cols, uint8_t rows) {
+	clear();
+}
+
+void LiquidCrystal::clear() {
+	memset(screen, ' ', sizeof(screen));
+	for (uint8_t r = 0; r < ROWS; r++) {
+		screen[r][COLS] = '\0';
+	}
+	col = 0;
+	row = 0;
+}
+
+void LiquidCrystal::noAutoscroll() {
+}
+
+void LiquidCrystal::setCursor(uint8_t col, uint8_t row) {
+	this->col = col;
+	this->row = row;
+}
+
+size_t LiquidCrystal::write(uint8_t c) {
+	if (row < ROWS && col < COLS) {
+		screen[row][col++] = c;
+	}
+	return 1;
+}
+
+const char* LiquidCrystal::line(uint8_t row) {
+	return screen[row < ROWS ? row : 0];
+}
@@ -0,0 +1,44 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIQUIDCRYSTAL_H_
+#define LIQUIDCRYSTAL_H_
+
+#include "Arduino.h"
+
+/** Host stand-in for HD44780 LCD - characters are written into RAM, so that tests can read screen content. */
+class LiquidCrystal: public Print {
+public:
+	LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3);
+	void begin(uint8_t cols, uint8_t rows);
+	void clear();
+	void noAutoscroll();
+	void setCursor(uint8_t col, uint8_t row);
+	size_t write(uint8_t c);
+	using Print::write;
+
+	/** Content of given row, always terminated. */
+	const char* line(uint8_t row);
+
+private:
+	const static uint8_t COLS = 20;
+	const static uint8_t ROWS = 4;
+	char screen[ROWS][COLS + 1];
+	uint8_t col;
+	uint8_t row;
+};
+
+#endif /* LIQUIDCRYSTAL_H_ */
@@ -0,0 +1,34 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef AVR_SLEEP_H_
+#define AVR_SLEEP_H_
+
+#include "Arduino.h"
+
+/*
+ * Host stand-in for avr-libc <avr/sleep.h>. In idle mode the CPU is woken up by the next Timer0 overflow - here it
+ * moves virtual clock to the next millisecond and accounts this time as sleep, see host_sleepNs().
+ */
+
+#define SLEEP_MODE_IDLE 0
+
+void set_sleep_mode(uint8_t mode);
+void sleep_enable();
+void sleep_disable();
+void sleep_cpu();
+
+#endif /* AVR_SLEEP_H_ */
@@ -0,0 +1,27 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef UTIL_ATOMIC_H_
+#define UTIL_ATOMIC_H_
+
+/* Host stand-in for avr-libc <util/atomic.h>, the host has no interrupts so block is executed once as it is. */
+
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_FORCEON 1
+
+#define ATOMIC_BLOCK(type) for (uint8_t __atomicOnce = 1; __atomicOnce; __atomicOnce = 0)
+
+#endif /* UTIL_ATOMIC_H_ */
@@ -17,13 +17,7 @@
 #include "Buttons.h"
 
 const static uint8_t PRESS_MS = 100;
-const static uint8_t BUTTON_NONE_MASK = B00000000;
-const static uint8_t BUTTON_NEXT_MASK = B00000001;
-const static uint8_t BUTTON_PREV_MASK = B00000010;
-const static uint8_t BUTTON_CLEAR_STATS_MASK = B00000011;
 
-/* Mask to record pressed button. */
-static volatile uint8_t butPressed = BUTTON_NONE_MASK;
 static volatile uint32_t pressMs = 0;
 
 static inline boolean process() {
@@ -37,19 +31,19 @@ static inline boolean process() {
 
 static void onNextIRQ() {
 	if (process()) {
-		butPressed = BUTTON_NEXT_MASK;
+		eb_post(BusEvent::BUTTON_NEXT);
 	}
 }
 
 static void onPrevIRQ() {
 	if (process()) {
-		butPressed = BUTTON_PREV_MASK;
+		eb_post(BusEvent::BUTTON_PREV);
 	}
 }
 
 static void onClearStatsIRQ() {
 	if (process()) {
-		butPressed = BUTTON_CLEAR_STATS_MASK;
+		eb_post(BusEvent::CLEAR_STATS);
 	}
 }
 
@@ -66,30 +60,7 @@ void Buttons::init() {
 Buttons::Buttons() {
 }
 
-uint8_t Buttons::listenerId() {
-	return LISTENER_ID_BUTTONS;
-}
-
 void inline Buttons::setupButton(uint8_t pin) {
 	pinMode(pin, INPUT);
 	digitalWrite(pin, HIGH); // enable pull-up resistor
 }
-
-inline void Buttons::cycle() {
-	if (butPressed == BUTTON_NEXT_MASK) {
-		eb_fire(BusEvent::BUTTON_NEXT);
-
-	} else if (butPressed == BUTTON_PREV_MASK) {
-		eb_fire(BusEvent::BUTTON_PREV);
-
-	} else if (butPressed == BUTTON_CLEAR_STATS_MASK) {
-		eb_fire(BusEvent::CLEAR_STATS);
-	}
-	butPressed = BUTTON_NONE_MASK;
-}
-
-void Buttons::onEvent(BusEvent event, va_list ap) {
-	if (event == BusEvent::CYCLE) {
-		cycle();
-	}
-}
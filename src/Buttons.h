@@ -24,16 +24,14 @@
 #include "Util.h"
 #include "Initializable.h"
 
-class Buttons: public BusListener, public Initializable {
+/** Each button press is posted from its interrupt routine to the event bus queue. */
+class Buttons: public Initializable {
 public:
 	Buttons();
 
 private:
 	void init();
-	void onEvent(BusEvent event, va_list ap);
-	uint8_t listenerId();
 	void inline setupButton(uint8_t pin);
-	void inline cycle();
 };
 
 #endif /* BUTTONS_H_ */
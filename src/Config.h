@@ -17,14 +17,16 @@
 #ifndef CONFIG_H_
 #define CONFIG_H_
 
+#include "Temperature.h"
+
 // ############### Relays ###############
 const static uint8_t RELAYS_AMOUNT = 2;
 
 /* Temperature threshold to enable first relay (DIG_PIN_RELAY_0) and start cooling. */
-const static int8_t RELAY_TEMP_SET_POINT_0 = 21;
+const static temp_t RELAY_TEMP_SET_POINT_0 = temp_deg(21);
 
 /* Temperature threshold to enable second relay (DIG_PIN_RELAY_1) and start cooling. */
-const static int8_t RELAY_TEMP_SET_POINT_1 = 25;
+const static temp_t RELAY_TEMP_SET_POINT_1 = temp_deg(25);
 
 /* Minimum time to switch next relay. 300000 - 5 minutes */
 const static uint32_t RELAY_DELAY_AFTER_SWITCH_MS = 300000;
@@ -55,10 +57,14 @@ const static uint8_t DEVICE_ID_STATS = 3;
 const static uint8_t DEVICE_ID_TIME_STATS = 4;
 
 // ############### Listeners ###############
-const static uint8_t LISTENER_ID_BUTTONS = 200;
-const static uint8_t LISTENER_ID_DISPLAY = 201;
-const static uint8_t LISTENER_ID_SUSPENDER = 202;
-const static uint8_t LISTENER_ID_STATUS = 203;
+/**
+ * Identifies component: position of BusListener in the dispatch table of EventBus, every listener instance needs its
+ * own slot, and owner of a Task for the profiler. The table is sized by #AMOUNT at compile time, so new listener starts
+ * here.
+ */
+enum class ListenerSlot : uint8_t {
+	TEMP_SENSOR, RELAY_DRIVER, TEMP_STATS, TIMER_STATS, DISPLAY, SUSPENDER, STATUS, AMOUNT
+};
 
 // ############### Display ###############
 /* Time to resume normal operation after pause for user input. */
@@ -66,42 +72,159 @@ const static uint16_t DISP_SHOW_INFO_MS = 3000;
 
 #define USE_FEHRENHEIT false
 
+// ############### Power ###############
+/* Puts CPU into idle mode between scheduled tasks instead of spinning in loop(). */
+#ifndef ENABLE_IDLE_SLEEP
+#define ENABLE_IDLE_SLEEP true
+#endif
+
+// ############### Profiler ###############
+/* Measures execution time of each listener and task, see Profiler.h. */
+#ifndef ENABLE_PROFILER
+#define ENABLE_PROFILER false
+#endif
+
+/* Frequency of printing profiler stats over serial. */
+const static uint32_t PR_DUMP_MS = 60000;
+
+// ############### Recorder ###############
+/* Records events and temperature changes, see Recorder.h. Trace is printed over serial after sending 'R'. */
+#ifndef ENABLE_RECORDER
+#define ENABLE_RECORDER false
+#endif
+
+/* Amount of recorded entries (8 bytes each), has to be power of two. */
+const static uint16_t REC_SIZE = 64;
+
+// ############### Temp Filters ###############
+/**
+ * Outputs of the filter chain in TempSensor, see TempFilter.h. Each filter reads output of an earlier stage: spike
+ * rejector reads raw probe, median and Kalman read spike rejector, EMA reads median.
+ */
+enum class FilterStage : uint8_t {
+	RAW, SPIKE, MEDIAN, EMA, KALMAN, AMOUNT
+};
+
+/* Probe differing from the last accepted one by more than that is dropped... */
+const static temp_t TF_SPIKE_MAX = temp_deg(3);
+
+/* ...unless it is the #TF_SPIKE_HOLD consecutive one - temperature has really changed. */
+const static uint8_t TF_SPIKE_HOLD = 4;
+
+/* EMA weight of the new probe is 1/2^#TF_EMA_SHIFT. */
+const static uint8_t TF_EMA_SHIFT = 2;
+
+/* Kalman process and measurement noise variance in 1/16 of (0.1 degree)^2. */
+const static int32_t TF_KALMAN_Q = 4;
+const static int32_t TF_KALMAN_R = 256;
+
 // ############### Relay Hysteresis Controller ###############
 /* Prevents frequent switches of the particular relay. 3600000 - 1 hour*/
 const static uint32_t RHC_RELAY_MIN_SWITCH_MS = 3600000;
 
-// RPC - Relay PID Controller
-const static float RPC_AMP_P = 1.0;
-const static float RPC_AMP_I = 2.0;
-const static float RPC_AMP_D = 0.3;
+/* Filter stage read by the controller. */
+const static FilterStage RHC_FILTER_STAGE = FilterStage::EMA;
+
+// RPC - Relay PID Controller, amplifications are given in #RPC_AMP_UNIT: 10 is 1.0
+const static int16_t RPC_AMP_UNIT = 10;
+const static int16_t RPC_AMP_P = 10;
+const static int16_t RPC_AMP_I = 20;
+const static int16_t RPC_AMP_D = 3;
 
 // PID threshold when relay should be switched on
-const static float RPC_PID_SWITCH_THRESHOLD = -10;
+const static temp_t RPC_PID_SWITCH_THRESHOLD = temp_deg(-10);
 
-// ############### Statistics ###############
-/** Take 24 temp probes per day to calculate agv/min/max per day*/
-const static uint8_t ST_PROBES_PER_DAY = 24;
+/*
+ * Anti-windup: integral part is limited to +/- this value, twice the threshold. It can keep the relay switched on its
+ * own, but long saturation does not keep it there long after temperature has crossed the set point.
+ */
+const static temp_t RPC_I_LIMIT = temp_deg(20);
+
+/* Filter stage read by the controller. */
+const static FilterStage RPC_FILTER_STAGE = FilterStage::KALMAN;
 
+// ############### Statistics ###############
 /**
- * Take probe every hour - 24 probes gives us full day:
- * #PROBES_PER_DAY * #DAY_PROBE_MS = 24h.
+ * Statistics are kept in tiers: minute, hour, day and week. Each tier is rolled up from entries of the finer one,
+ * minutes from #ST_ACTUAL_PROBE_MS probes. Minutes and hours are kept in RAM, days and weeks in EEPROM.
  */
-const static uint32_t ST_DAY_PROBE_MS = 3600000; // 3600000 = 1000 * 60 * 60; //TODO
+const static uint32_t ST_MINUTE_MS = 60000;
+const static uint32_t ST_HOUR_MS = 3600000;
+const static uint32_t ST_DAY_MS = 86400000;
+const static uint32_t ST_WEEK_MS = 604800000;
+
+/** Last quarter of an hour and last two days in RAM, 4 bytes each - see PackedTemp. */
+const static uint8_t ST_MINUTE_HISTORY_SIZE = 15;
+const static uint8_t ST_HOUR_HISTORY_SIZE = 48;
 
-// Frequency to probe for current temp, min and max (info on main screen)
+// Frequency to probe for current temp, min and max (info on main screen), statistic tiers are fed with it too
 const static uint32_t ST_ACTUAL_PROBE_MS = 300;
 
-/** Keep history for last 60 days. */
-const static uint8_t ST_DAY_HISTORY_SIZE = 60;
+/** Min and max on main screen are taken from last 24 hours, in 30 minutes buckets - 288 bytes of RAM. */
+const static uint32_t ST_ROLLING_MS = ST_DAY_MS;
+const static uint8_t ST_ROLLING_BUCKETS = 48;
+
+/** Keep history for last year, or as many days as fit into EEPROM, see Storage::DAY_CAPACITY. */
+const static uint16_t ST_DAY_HISTORY_MAX = 365;
+
+/** Keep history for last year. */
+const static uint8_t ST_WEEK_HISTORY_SIZE = 52;
+
+/**
+ * Unfinished day and week are stored in EEPROM each hour, so that they survive reboot. Each checkpoint goes to the
+ * next of #ST_CHECKPOINT_SLOTS slots, so one EEPROM cell is written every 4 hours.
+ */
+const static uint8_t ST_CHECKPOINT_SLOTS = 4;
+
+/** Days or weeks read from EEPROM at once when paging through the history, 8 bytes of RAM each. */
+const static uint8_t ST_READ_CACHE_SIZE = 7;
+
+/**
+ * RAM taken by TempStats, checked at compile time: ATmega328P has 2 KB for everything. It's a bit over the size on AVR,
+ * so that host build with 64-bit pointers fits too. TempLog comes on top of it.
+ */
+const static uint16_t ST_RAM_BYTES = 900;
+
+/**
+ * Compressed minute history (TempLog) kept by TempStats: 16 * 48 bytes hold over 24 hours at up to 4 bits per minute.
+ * It takes about 870 bytes of RAM, which leaves too little on ATmega328P - enable it on Mega only.
+ */
+#ifndef ENABLE_TEMP_LOG
+#define ENABLE_TEMP_LOG false
+#endif
+
+const static uint8_t TL_BLOCKS = 16;
+const static uint8_t TL_BLOCK_BYTES = 48;
+
+// ############### EEPROM ###############
+/* Writes queued by EepromWriter before they get flushed, 3 bytes of RAM each. */
+const static uint8_t EE_QUEUE_SIZE = 16;
 
 // ############### Temp Sensor ###############
 /**
- * We take #TS_PROBES_SIZE probes from temp sensor, each one with delay of #PROBE_DELAY milliseconds.
- * After collecting all required probes we calculate median and this is the temperature.
+ * Temperature is the median of the last #TS_MEDIAN_WINDOW probes, each one taken with delay of #TS_PROBE_FREQ_MS
+ * milliseconds, or longer if conversion takes more time. It is updated with every probe. Window size must be odd.
  */
-// log statement assumes at least 4 probes - adopt it after changing size!
-const static uint8_t TS_PROBES_SIZE = 3;
-const static uint8_t TS_PROBES_MED_IDX = 1; // it's an array index, starting from 0
+const static uint8_t TS_MEDIAN_WINDOW = 15;
 const static uint32_t TS_PROBE_FREQ_MS = 200;
 
+/**
+ * Probe period adapts to the temperature: after #TS_STABLE_PROBES probes in a row where neither the Kalman estimate
+ * moved, nor raw probe differed from the median by more than #TS_STABLE_DELTA, the period doubles up to
+ * #TS_PROBE_MAX_MS. Any larger change brings it back to the shortest one. Setting #TS_PROBE_MAX_MS to
+ * #TS_PROBE_FREQ_MS disables it.
+ */
+const static uint32_t TS_PROBE_MAX_MS = 32000;
+const static temp_t TS_STABLE_DELTA = 2;
+const static uint8_t TS_STABLE_PROBES = 8;
+
+/*
+ * Max amount of DS18B20 sensors on #DIG_PIN_TEMP_SENSOR. First one is used by controllers, others just provide
+ * temperature - shown on the display page that follows the main one.
+ */
+const static uint8_t TS_SENSORS_MAX = 4;
+
+/* Delay before checking again conversion that has not been finished in expected time. */
+const static uint32_t TS_CONVERSION_RETRY_MS = 10;
+
 #endif /* CONFIG_H_ */
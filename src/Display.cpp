@@ -17,14 +17,19 @@
 #include "Display.h"
 
 Display::Display(TempSensor *tempSensor, TempStats *tempStats, TimerStats* timerStats, RelayDriver* relayDriver) :
-		lcd(DIG_PIN_LCD_RS, DIG_PIN_LCD_ENABLE, DIG_PIN_LCD_D4, DIG_PIN_LCD_D5, DIG_PIN_LCD_D6, DIG_PIN_LCD_D7), tempSensor(
+		BusListener(ListenerSlot::DISPLAY, eb_mask(BusEventGroup::BUTTON) | eb_mask(BusEventGroup::SERVICE)), Task(
+				ListenerSlot::DISPLAY), lcd(
+				DIG_PIN_LCD_RS, DIG_PIN_LCD_ENABLE, DIG_PIN_LCD_D4, DIG_PIN_LCD_D5, DIG_PIN_LCD_D6, DIG_PIN_LCD_D7), tempSensor(
 				tempSensor), tempStats(tempStats), timerStats(timerStats), relayDriver(relayDriver), mainState(this), runtimeState(
-				this), relayTimeState(this), relaSetPointdState(this), dayStatsState(this), clearStatsState(this), driver(
-				6, &mainState, &runtimeState, &relayTimeState, &relaSetPointdState, &dayStatsState, &clearStatsState) {
-}
-
-uint8_t Display::listenerId() {
-	return LISTENER_ID_DISPLAY;
+				this), relayTimeState(this), relaSetPointdState(this), dayStatsState(this), clearStatsState(this), sensorsState(
+				this),
+#if ENABLE_PROFILER
+		diagState(this), driver(8, &mainState, &runtimeState, &relayTimeState, &relaSetPointdState, &dayStatsState,
+				&clearStatsState, &sensorsState, &diagState) {
+#else
+		driver(7, &mainState, &runtimeState, &relayTimeState, &relaSetPointdState, &dayStatsState, &clearStatsState,
+				&sensorsState) {
+#endif
 }
 
 void Display::init() {
@@ -36,16 +41,22 @@ void Display::init() {
 
 	lcd.setCursor(0, 0);
 	driver.changeState(STATE_MAIN);
+	sc_schedule(this, UPDATE_FREQ);
+}
+
+uint32_t Display::run() {
+	driver.execute(BusEvent::CYCLE);
+	return UPDATE_FREQ;
 }
 
-void Display::onEvent(BusEvent event, va_list ap) {
-	if (event == BusEvent::SERVICE_RESUME) {
+void Display::onEvent(const BusMsg* msg) {
+	if (msg->event == BusEvent::SERVICE_RESUME) {
 		driver.changeState(STATE_MAIN);
 
-	} else if (event == BusEvent::CLEAR_STATS) {
+	} else if (msg->event == BusEvent::CLEAR_STATS) {
 		driver.changeState(STATE_CLEAR_STATS);
 	}
-	driver.execute(event);
+	driver.execute(msg->event);
 }
 
 inline void Display::println(uint8_t row, const __FlashStringHelper *ifsh) {
@@ -71,10 +82,11 @@ inline void Display::println(uint8_t row, char *fmt, ...) {
 
 	va_list va;
 	va_start(va, fmt);
-	uint8_t chars = vsprintf(lcdBuf, fmt, va);
+	int16_t chars = vsnprintf(lcdBuf, sizeof(lcdBuf), fmt, va);
 	va_end(va);
 
-	lcdBufClRight(chars);
+	// longer line is cut
+	lcdBufClRight(max(min(chars, (int16_t) LINE_LENGTH), (int16_t) 0));
 	lcd.print(lcdBuf);
 }
 
@@ -91,32 +103,22 @@ inline void Display::clrow(uint8_t row) {
 	lcd.setCursor(0, row);
 }
 
+inline char* Display::ftemp(uint8_t idx, temp_t temp) {
+	return temp_formatShort(tempBuf[idx], temp);
+}
+
 void Display::printTime(uint8_t row, Time* time) {
 	println(row, "%04d -> %02d:%02d:%02d", time->dd, time->hh, time->mm, time->ss);
 }
 
 // ##################### DisplayState #####################
 Display::DisplayState::DisplayState(Display* display) :
-		display(display), lastUpdateMs(0) {
+		display(display) {
 }
 
 Display::DisplayState::~DisplayState() {
 }
 
-inline boolean Display::DisplayState::shouldUpdate() {
-	boolean should = false;
-	uint32_t millis = util_ms();
-	if (millis - lastUpdateMs >= UPDATE_FREQ) {
-		should = true;
-		lastUpdateMs = millis;
-	}
-	return should;
-}
-
-void Display::DisplayState::init() {
-	lastUpdateMs = 0;
-}
-
 // ##################### MainState #####################
 Display::MainState::MainState(Display* display) :
 		DisplayState(display) {
@@ -126,19 +128,18 @@ Display::MainState::~MainState() {
 }
 
 inline void Display::MainState::update() {
-	int8_t tempNow = display->tempSensor->getQuickTemp();
+	temp_t tempNow = display->tempSensor->getQuickTemp();
 	Temp* actual = display->tempStats->actual();
-	display->println(1, "%4d|%5d|%5d", tempNow, actual->min, actual->max);
+	display->println(1, "%5s|%5s|%4s", display->ftemp(0, tempNow), display->ftemp(1, actual->min),
+			display->ftemp(2, actual->max));
 }
 
 uint8_t Display::MainState::execute(BusEvent event) {
 	if (event == BusEvent::CYCLE) {
-		if (shouldUpdate()) {
-			update();
-		}
+		update();
 	} else {
 		if (event == BusEvent::BUTTON_NEXT) {
-			return STATE_RUNTIME;
+			return STATE_SENSORS;
 
 		} else if (event == BusEvent::BUTTON_PREV) {
 			return STATE_DAY_STATS;
@@ -148,8 +149,7 @@ uint8_t Display::MainState::execute(BusEvent event) {
 }
 
 void Display::MainState::init() {
-	DisplayState::init();
-	display->println(0, F(" NOW|  MIN|  MAX"));
+	display->println(0, F("  NOW|  MIN| MAX"));
 	update();
 }
 
@@ -168,7 +168,7 @@ uint8_t Display::ClearStatsState::execute(BusEvent event) {
 
 	} else if (util_ms() - showMs > DISP_SHOW_INFO_MS || event == BusEvent::BUTTON_NEXT
 			|| event == BusEvent::BUTTON_PREV) {
-		eb_fire(BusEvent::SERVICE_RESUME);
+		eb_post(BusEvent::SERVICE_RESUME);
 		return STATE_MAIN;
 	}
 	return STATE_NOCHANGE;
@@ -178,6 +178,62 @@ void Display::ClearStatsState::init() {
 	showMs = util_ms();
 }
 
+// ##################### SensorsState #####################
+Display::SensorsState::SensorsState(Display* display) :
+		DisplayState(display), sensorIdx(0) {
+}
+
+Display::SensorsState::~SensorsState() {
+}
+
+uint8_t Display::SensorsState::execute(BusEvent event) {
+	if (event == BusEvent::BUTTON_NEXT) {
+		sensorIdx++;
+		if (sensorIdx > pages()) {
+			return STATE_RUNTIME;
+		}
+
+	} else if (event == BusEvent::BUTTON_PREV) {
+		// cannot decrease before checking because it's unsigned int
+		if (sensorIdx == 0) {
+			return STATE_MAIN;
+		}
+		sensorIdx--;
+	}
+	updateDisplay();
+	return STATE_NOCHANGE;
+}
+
+/* Without sensors there is still one page, it shows disconnected first sensor. */
+inline uint8_t Display::SensorsState::pages() {
+	return max(display->tempSensor->getSensorsAmount(), (uint8_t) 1);
+}
+
+inline void Display::SensorsState::updateDisplay() {
+	TempSensor* sensor = display->tempSensor;
+	if (sensorIdx == pages()) {
+		// adaptive probe period and average amount of probes per minute since boot
+		uint32_t probeMs = sensor->getProbeMs();
+		uint32_t minutes = util_ms() / 60000;
+		display->println(0, "Probe each%3lu.%lus", (unsigned long) (probeMs / 1000),
+				(unsigned long) (probeMs % 1000 / 100));
+		display->println(1, "%5lu/min avg", (unsigned long) (sensor->getProbes() / max(minutes, (uint32_t) 1)));
+		return;
+	}
+	uint8_t sensors = sensor->getSensorsAmount();
+	if (sensors == 0) {
+		display->println(0, F("No sensor"));
+	} else {
+		display->println(0, "Sensor %u of %u", sensorIdx + 1, sensors);
+	}
+	display->println(1, "%14s%c", display->ftemp(0, sensor->getSensorTemp(sensorIdx)), (USE_FEHRENHEIT ? 'f' : 0xDF));
+}
+
+void Display::SensorsState::init() {
+	sensorIdx = 0;
+	updateDisplay();
+}
+
 // ##################### RuntimeState #####################
 Display::RuntimeState::RuntimeState(Display* display) :
 		DisplayState(display) {
@@ -192,11 +248,11 @@ uint8_t Display::RuntimeState::execute(BusEvent event) {
 			return STATE_RELAY_TIME;
 
 		} else if (event == BusEvent::BUTTON_PREV) {
-			return STATE_MAIN;
+			return STATE_SENSORS;
 		}
 	}
 
-	if (shouldUpdate()) {
+	if (event == BusEvent::CYCLE) {
 		update();
 	}
 
@@ -211,7 +267,6 @@ void Display::RuntimeState::init() {
 #if LOG
 	log(F("DSRS-init"));
 #endif
-	DisplayState::init();
 	display->println(0, F("System on time  "));
 	update();
 }
@@ -240,7 +295,7 @@ uint8_t Display::RelayTimeState::execute(BusEvent event) {
 		relayIdx--;
 		updateDisplay();
 
-	} else if (shouldUpdate()) {
+	} else if (event == BusEvent::CYCLE) {
 		updateDisplayTime();
 	}
 	return STATE_NOCHANGE;
@@ -260,7 +315,6 @@ void Display::RelayTimeState::init() {
 #if LOG
 	log(F("DSRT-init"));
 #endif
-	DisplayState::init();
 	relayIdx = 0;
 	updateDisplay();
 }
@@ -295,7 +349,8 @@ uint8_t Display::RelaySetPointdState::execute(BusEvent event) {
 
 inline void Display::RelaySetPointdState::updateDisplay() {
 	display->println(0, "Relay %d set", relayIdx + 1);
-	display->println(1, "  point on %d%c", display->relayDriver->getSetPoint(relayIdx), (USE_FEHRENHEIT ? 'f' : 0xDF));
+	display->println(1, "  point on %s%c", display->ftemp(0, display->relayDriver->getSetPoint(relayIdx)),
+			(USE_FEHRENHEIT ? 'f' : 0xDF));
 }
 
 void Display::RelaySetPointdState::init() {
@@ -318,10 +373,10 @@ uint8_t Display::DayStatsState::execute(BusEvent event) {
 
 	if (event == BusEvent::BUTTON_NEXT) {
 		if (daySize == 0) {
-			return STATE_MAIN;
+			return STATE_DAY_STATS_NEXT;
 		}
 		if (!display->tempStats->di()->hasNext()) {
-			return STATE_MAIN;
+			return STATE_DAY_STATS_NEXT;
 		}
 		updateDisplay(display->tempStats->di()->next());
 	} else if (event == BusEvent::BUTTON_PREV) {
@@ -334,8 +389,8 @@ uint8_t Display::DayStatsState::execute(BusEvent event) {
 }
 
 inline void Display::DayStatsState::updateDisplay(Temp* temp) {
-	display->println(0, F("DDD->MIN|MAX|AVG"));
-	display->println(1, "%3d->%3d|%3d|%3d", temp->day, temp->min, temp->max, temp->avg);
+	display->println(0, "%3u day avg%5s", temp->day, display->ftemp(0, temp->avg));
+	display->println(1, "lo%5s hi%5s", display->ftemp(1, temp->min), display->ftemp(2, temp->max));
 }
 
 inline uint8_t Display::DayStatsState::getMM(uint32_t durationMs) {
@@ -357,6 +412,48 @@ void Display::DayStatsState::init() {
 		display->println(1, F("  is empty"));
 	} else {
 		display->println(0, F("Statistics"));
-		display->println(1, "  for %d days", daySize);
+		display->println(1, "  for %u days", daySize);
+	}
+}
+
+#if ENABLE_PROFILER
+// ##################### DiagState #####################
+const static uint8_t DIAG_PAGES = 2 * EB_LISTENERS_AMOUNT;
+
+Display::DiagState::DiagState(Display* display) :
+		DisplayState(display), pageIdx(0) {
+}
+
+Display::DiagState::~DiagState() {
+}
+
+uint8_t Display::DiagState::execute(BusEvent event) {
+	if (event == BusEvent::BUTTON_NEXT) {
+		pageIdx++;
+		if (pageIdx == DIAG_PAGES) {
+			return STATE_MAIN;
+		}
+	} else if (event == BusEvent::BUTTON_PREV) {
+		if (pageIdx == 0) {
+			return STATE_DAY_STATS;
+		}
+		pageIdx--;
 	}
+	updateDisplay();
+	return STATE_NOCHANGE;
+}
+
+inline void Display::DiagState::updateDisplay() {
+	boolean task = pageIdx >= EB_LISTENERS_AMOUNT;
+	uint8_t slot = task ? pageIdx - EB_LISTENERS_AMOUNT : pageIdx;
+	const ProfileStats* st = pr_stats(task ? ProfileKind::TASK : ProfileKind::EVENT, static_cast<ListenerSlot>(slot));
+	uint32_t avg = st->count == 0 ? 0 : st->totalUs / st->count;
+	display->println(0, "%c%-2d %11lu", task ? 'T' : 'E', slot, (unsigned long) st->count);
+	display->println(1, "%7lu|%8lu", (unsigned long) avg, (unsigned long) st->maxUs);
 }
+
+void Display::DiagState::init() {
+	pageIdx = 0;
+	updateDisplay();
+}
+#endif
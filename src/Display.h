@@ -28,11 +28,13 @@
 #include "Initializable.h"
 #include "TempStats.h"
 #include "TimerStats.h"
+#include "Scheduler.h"
+#include "Profiler.h"
 
-class Display: public BusListener, public Initializable {
+/** Display changes its state on bus events and refreshes content every #UPDATE_FREQ by executing with CYCLE. */
+class Display: public BusListener, public Initializable, public Task {
 public:
 	Display(TempSensor* tempSensor, TempStats* tempStats, TimerStats* timerStats, RelayDriver* relayDriver);
-	uint8_t listenerId();
 private:
 
 	enum DisplayStates {
@@ -41,7 +43,12 @@ private:
 		STATE_RELAY_TIME = 2,
 		RELAY_SET_POINT = 3,
 		STATE_DAY_STATS = 4,
-		STATE_CLEAR_STATS = 5
+		STATE_CLEAR_STATS = 5,
+		STATE_SENSORS = 6,
+		STATE_DIAG = 7,
+
+		/* Diagnostics are hidden behind the last day statistics, and only when profiler is enabled. */
+		STATE_DAY_STATS_NEXT = ENABLE_PROFILER ? STATE_DIAG : STATE_MAIN
 	};
 
 	class DisplayState: public StateMachine {
@@ -49,12 +56,7 @@ private:
 		DisplayState(Display* display);
 		virtual ~DisplayState();
 	protected:
-		inline boolean shouldUpdate();
 		Display* display;
-		virtual void init();
-	private:
-		const static uint16_t UPDATE_FREQ = 500;
-		uint32_t lastUpdateMs;
 	};
 
 	/** Shows main/start screen */
@@ -68,6 +70,19 @@ private:
 		inline void update();
 	};
 
+	/** Shows last probe of each sensor found on the bus, one page per sensor, and then the probe period. */
+	class SensorsState: public DisplayState {
+	public:
+		SensorsState(Display* display);
+		virtual ~SensorsState();
+		virtual uint8_t execute(BusEvent event);
+	private:
+		virtual void init();
+		uint8_t sensorIdx;
+		inline uint8_t pages();
+		inline void updateDisplay();
+	};
+
 	/** Shows runtime for system . */
 	class RuntimeState: public DisplayState {
 	public:
@@ -112,7 +127,7 @@ private:
 		virtual uint8_t execute(BusEvent event);
 	private:
 		Display* display;
-		uint8_t daySize;
+		uint16_t daySize;
 		virtual void init();
 		inline void updateDisplay(Temp* temp);
 
@@ -135,31 +150,60 @@ private:
 		uint32_t showMs;
 	};
 
+#if ENABLE_PROFILER
+	/** Shows profiler stats, one page for each component and kind: count, avg and max in microseconds. */
+	class DiagState: public DisplayState {
+	public:
+		DiagState(Display* display);
+		virtual ~DiagState();
+		virtual uint8_t execute(BusEvent event);
+	private:
+		virtual void init();
+		uint8_t pageIdx;
+		inline void updateDisplay();
+	};
+#endif
+
 	LiquidCrystal lcd;
 	TempSensor* const tempSensor;
 	TempStats* const tempStats;
 	TimerStats* const timerStats;
 	RelayDriver* const relayDriver;
 	const static uint8_t LINE_LENGTH = 16;
+	const static uint16_t UPDATE_FREQ = 500;
 
 	// buffer has to be at lest 1 character larger than line due to terminating character.
 	// we add few more bytes in case one string would be a bit longer than expected.
 	char lcdBuf[LINE_LENGTH + 4];
+
+	// formatted temperatures, one line shows up to 3 of them.
+	char tempBuf[3][8];
 	MainState mainState;
 	RuntimeState runtimeState;
 	RelayTimeState relayTimeState;
 	RelaySetPointdState relaSetPointdState;
 	DayStatsState dayStatsState;
 	ClearStatsState clearStatsState;
+	SensorsState sensorsState;
+#if ENABLE_PROFILER
+	DiagState diagState;
+#endif
 	MachineDriver driver;
 
 	void init();
-	void onEvent(BusEvent event, va_list ap);
+	void onEvent(const BusMsg* msg);
+	uint32_t run();
 	inline void clrow(uint8_t row);
 	inline void println(uint8_t row, char *fmt, ...);
 	inline void println(uint8_t row, const __FlashStringHelper *ifsh);
 	inline void lcdBufClRight(uint8_t from);
 	void printTime(uint8_t row, Time* time);
+
+	/*
+	 * Formats temperature into #tempBuf[idx] so that it can be passed to #println() as %s, in at most
+	 * #TEMP_SHORT_CHARS: three of them with separators fit into a line.
+	 */
+	inline char* ftemp(uint8_t idx, temp_t temp);
 };
 
 #endif /* DISPLAY_H_ */
@@ -0,0 +1,77 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "EepromWriter.h"
+
+typedef struct {
+	uint16_t eIdx;
+	uint8_t val;
+} EeWrite;
+
+static EeWrite queue[EE_QUEUE_SIZE];
+static uint8_t queued = 0;
+static uint32_t writes = 0;
+static uint32_t saved = 0;
+
+static int8_t findQueued(uint16_t eIdx) {
+	for (uint8_t qIdx = 0; qIdx < queued; qIdx++) {
+		if (queue[qIdx].eIdx == eIdx) {
+			return qIdx;
+		}
+	}
+	return -1;
+}
+
+uint8_t ee_read(uint16_t eIdx) {
+	int8_t qIdx = findQueued(eIdx);
+	return qIdx < 0 ? EEPROM.read(eIdx) : queue[qIdx].val;
+}
+
+void ee_write(uint16_t eIdx, uint8_t val) {
+	int8_t qIdx = findQueued(eIdx);
+	if (qIdx >= 0) {
+		queue[qIdx].val = val;
+		saved++;
+		return;
+	}
+	if (queued == EE_QUEUE_SIZE) {
+		ee_flush();
+	}
+	queue[queued].eIdx = eIdx;
+	queue[queued].val = val;
+	queued++;
+}
+
+void ee_flush() {
+	for (uint8_t qIdx = 0; qIdx < queued; qIdx++) {
+		EeWrite* wr = &queue[qIdx];
+		if (EEPROM.read(wr->eIdx) == wr->val) {
+			saved++;
+		} else {
+			EEPROM.write(wr->eIdx, wr->val);
+			writes++;
+		}
+	}
+	queued = 0;
+}
+
+uint32_t ee_writes() {
+	return writes;
+}
+
+uint32_t ee_saved() {
+	return saved;
+}
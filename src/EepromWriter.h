@@ -0,0 +1,45 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EEPROMWRITER_H_
+#define EEPROMWRITER_H_
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "Config.h"
+
+/**
+ * All writes to EEPROM go through here. Written bytes are queued and reach EEPROM on #ee_flush() - called once per
+ * loop() and by Storage wherever order of writes matters. Repeated write to the same cell before flush replaces the
+ * queued one, and byte equal to the content of the cell is not written at all - cell wears out only on real change.
+ */
+
+/** Reads the cell, queued value if there is one. */
+uint8_t ee_read(uint16_t eIdx);
+
+/** Queues write, flushes the queue first if it has #EE_QUEUE_SIZE entries already. */
+void ee_write(uint16_t eIdx, uint8_t val);
+
+/** Writes queued bytes in the order of their first write. */
+void ee_flush();
+
+/** Amount of bytes physically written since boot. */
+uint32_t ee_writes();
+
+/** Amount of writes that did not reach EEPROM: merged in the queue or equal to the cell content. */
+uint32_t ee_saved();
+
+#endif /* EEPROMWRITER_H_ */
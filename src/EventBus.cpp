@@ -15,50 +15,140 @@
  * limitations under the License.
  */
 #include "EventBus.h"
+#include "Recorder.h"
 
-const static uint8_t LISTNERS_MAX = 10;
-static BusListener* listeners[LISTNERS_MAX];
-static uint8_t listenersAmount = 0;
+static BusListener* listeners[EB_LISTENERS_AMOUNT];
+
+/* For each event (#eb_idx) bit mask of listeners (index in #listeners) registered for this event. */
+static ListenerMask dispatch[EB_EVENTS_AMOUNT];
+
+/* Queue size has to be power of two, indexes are free running and masked on access. */
+const static uint8_t QUEUE_SIZE = 8;
+const static uint8_t QUEUE_MASK = QUEUE_SIZE - 1;
+static BusMsg queue[QUEUE_SIZE];
+
+/* Next free slot, moved only by producers (#eb_post) with interrupts disabled. */
+static volatile uint8_t queueHead = 0;
+
+/* Next message to be fired, moved only by #eb_drain(). */
+static volatile uint8_t queueTail = 0;
 
 BusListener::~BusListener() {
 }
 
-BusListener::BusListener() {
-	eb_register(this);
+BusListener::BusListener(ListenerSlot slot, BusEventMask events) :
+		lSlot(slot) {
+	eb_register(this, events);
 }
 
-void eb_register(BusListener* listener) {
-	if (listenersAmount == LISTNERS_MAX) {
+ListenerSlot BusListener::slot() {
+	return lSlot;
+}
+
+boolean eb_register(BusListener* listener, BusEventMask events) {
+	uint8_t lIdx = static_cast<uint8_t>(listener->slot());
+	if (listeners[lIdx] != NULL && listeners[lIdx] != listener) {
 #if LOG
-		log(F("EB LIS ERR (%d) !"), listenersAmount);
+		log(F("EB SLOT %d TAKEN"), lIdx);
 #endif
-		return;
+		return false;
 	}
 
 #if TRACE
-	log(F("EB REG %d"), listenersAmount);
+	log(F("EB REG %d"), lIdx);
 #endif
-	listeners[listenersAmount++] = listener;
+	ListenerMask lMask = (ListenerMask) 1 << lIdx;
+	for (uint8_t eIdx = 0; eIdx < EB_EVENTS_AMOUNT; eIdx++) {
+		if (events & (1 << eIdx)) {
+			dispatch[eIdx] |= lMask;
+		} else {
+			dispatch[eIdx] &= ~lMask;
+		}
+	}
+	listeners[lIdx] = listener;
+	return true;
 }
 
-void eb_fire(BusEvent event, ...) {
+BusMsg eb_msg(BusEvent event, uint8_t sourceId) {
+	BusMsg msg;
+	msg.event = event;
+	msg.sourceId = sourceId;
+	msg.data.value = 0;
+	msg.ms = util_ms();
+	return msg;
+}
+
+void eb_fire(BusEvent event) {
+	BusMsg msg = eb_msg(event, 0);
+	eb_fire(&msg);
+}
+
+void eb_fire(const BusMsg* msg) {
 #if LOG
-	if (event != BusEvent::CYCLE) {
-		log(F("EB FR: %d"), event);
+	if (msg->event != BusEvent::CYCLE) {
+		log(F("EB FR: %d"), msg->event);
+	}
+#endif
+#if ENABLE_RECORDER
+	if (msg->event != BusEvent::CYCLE) {
+		rec_event(msg);
 	}
 #endif
 
-	for (uint8_t idx = 0; idx < listenersAmount; idx++) {
-		va_list ap;
-		va_start(ap, event);
+	ListenerMask lMask = dispatch[eb_idx(msg->event)];
+	for (uint8_t idx = 0; lMask != 0; idx++, lMask >>= 1) {
+		if ((lMask & 1) == 0) {
+			continue;
+		}
 #if TRACE
-		if (event != BusEvent::CYCLE) {
-			log(F("EB LT: %d"), listeners[idx]->listenerId());
+		if (msg->event != BusEvent::CYCLE) {
+			log(F("EB LT: %d"), idx);
 		}
 #endif
-		listeners[idx]->onEvent(event, ap);
-		va_end(ap);
+#if ENABLE_PROFILER
+		uint32_t startUs = pr_us();
+		listeners[idx]->onEvent(msg);
+		pr_record(ProfileKind::EVENT, static_cast<ListenerSlot>(idx), startUs);
+#else
+		listeners[idx]->onEvent(msg);
+#endif
+	}
+}
+
+boolean eb_post(const BusMsg* msg) {
+	boolean posted = false;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		uint8_t head = queueHead;
+		if ((uint8_t) (head - queueTail) < QUEUE_SIZE) {
+			queue[head & QUEUE_MASK] = *msg;
+			queueHead = head + 1;
+			posted = true;
+		}
+	}
+#if LOG
+	if (!posted) {
+		log(F("EB Q FULL %d"), msg->event);
 	}
+#endif
+	return posted;
+}
+
+boolean eb_post(BusEvent event) {
+	BusMsg msg = eb_msg(event, 0);
+	return eb_post(&msg);
+}
+
+void eb_drain() {
+	uint8_t head = queueHead;
+	while (queueTail != head) {
+		BusMsg msg = queue[queueTail & QUEUE_MASK];
+		queueTail++;
+		eb_fire(&msg);
+	}
+}
+
+boolean eb_pending() {
+	return queueHead != queueTail;
 }
 
 boolean eb_inGroup(BusEvent eventEnum, BusEventGroup group) {
@@ -19,30 +19,34 @@
 
 #include "Arduino.h"
 #include "ArdLog.h"
+#include "Util.h"
+#include "Config.h"
+#include "Profiler.h"
+#include "util/atomic.h"
 
-enum class BusEvent {
-	/** Parameters: 0 - relay ID */
+enum class BusEvent : uint8_t {
+	/** Payload: data.relayId */
 	RELAY_ON = 10,
 
-	/** Parameters: 0 - relay ID */
+	/** Payload: data.relayId */
 	RELAY_OFF = 11,
 
-	/** Parameters: none */
+	/** Payload: none */
 	BUTTON_NEXT = 20,
 
-	/** Parameters: none */
+	/** Payload: none */
 	BUTTON_PREV = 21,
 
-	/** Parameters: none */
+	/** Payload: none */
 	SERVICE_SUSPEND = 30,
 
-	/** Parameters: none */
+	/** Payload: none */
 	SERVICE_RESUME = 31,
 
-	/** Parameters: none */
+	/** Payload: none */
 	CLEAR_STATS= 32,
 
-	/** Parameters: none */
+	/** Payload: none */
 	CYCLE = 255,
 };
 
@@ -50,18 +54,106 @@ enum class BusEventGroup {
 	RELAY, BUTTON, SERVICE
 };
 
+/** Set of events, each event is represented by single bit given by #eb_idx(). */
+typedef uint16_t BusEventMask;
+
+/** Amount of events in #BusEvent. */
+const static uint8_t EB_EVENTS_AMOUNT = 8;
+
+/** Position of the event in #BusEventMask. */
+constexpr uint8_t eb_idx(BusEvent event) {
+	return event == BusEvent::RELAY_ON ? 0 :
+			event == BusEvent::RELAY_OFF ? 1 :
+			event == BusEvent::BUTTON_NEXT ? 2 :
+			event == BusEvent::BUTTON_PREV ? 3 :
+			event == BusEvent::SERVICE_SUSPEND ? 4 :
+			event == BusEvent::SERVICE_RESUME ? 5 :
+			event == BusEvent::CLEAR_STATS ? 6 : 7;
+}
+
+constexpr BusEventMask eb_mask(BusEvent event) {
+	return 1 << eb_idx(event);
+}
+
+constexpr BusEventMask eb_mask(BusEventGroup group) {
+	return group == BusEventGroup::RELAY ? eb_mask(BusEvent::RELAY_ON) | eb_mask(BusEvent::RELAY_OFF) :
+			group == BusEventGroup::BUTTON ? eb_mask(BusEvent::BUTTON_NEXT) | eb_mask(BusEvent::BUTTON_PREV) :
+			eb_mask(BusEvent::SERVICE_SUSPEND) | eb_mask(BusEvent::SERVICE_RESUME) | eb_mask(BusEvent::CLEAR_STATS);
+}
+
+/** Set of listeners, each listener is represented by single bit given by its #ListenerSlot. */
+typedef uint16_t ListenerMask;
+
+/** Size of the dispatch table, given by #ListenerSlot. */
+const static uint8_t EB_LISTENERS_AMOUNT = static_cast<uint8_t>(ListenerSlot::AMOUNT);
+
+static_assert(EB_LISTENERS_AMOUNT <= sizeof(ListenerMask) * 8, "ListenerMask has no bit for each ListenerSlot");
+
+/** Event together with its payload. It's small enough to be copied, queued or recorded. */
+typedef struct {
+	BusEvent event;
+
+	/** Device (DEVICE_ID_XXX) that has fired this event, 0 if not known. */
+	uint8_t sourceId;
+
+	/** Payload, each event uses field documented on #BusEvent. */
+	union {
+		uint8_t relayId;
+		int16_t value;
+	} data;
+
+	/** #util_ms() at the time when event has been created. */
+	uint32_t ms;
+} BusMsg;
+
+/** Creates message without payload. */
+BusMsg eb_msg(BusEvent event, uint8_t sourceId);
+
 class BusListener {
 public:
-	virtual void onEvent(BusEvent event, va_list ap) = 0;
-	virtual uint8_t listenerId() = 0;
+	virtual void onEvent(const BusMsg* msg) = 0;
+	ListenerSlot slot();
 
 protected:
 	virtual ~BusListener();
-	BusListener();
+
+	/** #slot - own position in the dispatch table, #events - only those events will be delivered to #onEvent(). */
+	BusListener(ListenerSlot slot, BusEventMask events);
+
+private:
+	const ListenerSlot lSlot;
 };
 
 boolean eb_inGroup(BusEvent event, BusEventGroup group);
-void eb_register(BusListener* listener);
-void eb_fire(BusEvent event, ...);
+
+/**
+ * Places listener in its slot, registering the same listener again only changes its events. Returns false and keeps
+ * the first one when the slot is taken by another listener.
+ */
+boolean eb_register(BusListener* listener, BusEventMask events);
+
+/** Delivers message to all listeners registered for its event. */
+void eb_fire(const BusMsg* msg);
+
+/** Fires event without payload. */
+void eb_fire(BusEvent event);
+
+/**
+ * Appends message to the queue, it will be fired by the next #eb_drain(). It's safe to call it from interrupt
+ * routine and from #BusListener#onEvent(). Returns false if queue is full and message has been dropped.
+ */
+boolean eb_post(const BusMsg* msg);
+
+/** Posts event without payload. */
+boolean eb_post(BusEvent event);
+
+/**
+ * Fires queued messages in FIFO order. Messages posted while draining wait for the next call, this keeps time
+ * spent here and stack depth bounded. Should be called once per loop().
+ */
+void eb_drain();
+
+/** True if there are messages waiting for #eb_drain(). */
+boolean eb_pending();
 
 #endif /* EVENTBUS_H_ */
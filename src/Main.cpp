@@ -28,6 +28,15 @@
 #include "Initializable.h"
 #include "TempStats.h"
 #include "TimerStats.h"
+#include "Scheduler.h"
+#include "Profiler.h"
+#include "Recorder.h"
+#include "EepromWriter.h"
+#include "Config.h"
+
+#if ENABLE_IDLE_SLEEP
+#include <avr/sleep.h>
+#endif
 
 static TempSensor* tempSensor;
 static TempStats* tempStats;
@@ -70,7 +79,44 @@ void setup() {
 	init(display);
 	init(buttons);
 	timerStats->init();
+#if ENABLE_PROFILER
+	pr_setup();
+#endif
+#if ENABLE_RECORDER
+	rec_setup();
+#endif
+}
+
+#if ENABLE_IDLE_SLEEP
+/*
+ * Sleeps until the next task is due or an event has been posted by ISR. Idle mode keeps timers running, so Timer0
+ * wakes CPU up every millisecond to update millis(), and so does every button interrupt.
+ */
+static void idle() {
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	while (true) {
+		cli();
+		util_cycle();
+		if (eb_pending() || sc_nextMs() == 0) {
+			sei();
+			break;
+		}
+		sleep_enable();
+		sei(); // instruction following sei() is executed before any pending interrupt
+		sleep_cpu();
+		sleep_disable();
+	}
 }
+#endif
+
+#if ENABLE_RECORDER
+/* Called by Arduino core after loop() when serial data is available. */
+void serialEvent() {
+	if (Serial.read() == 'R') {
+		rec_dump();
+	}
+}
+#endif
 
 uint32_t lms = 0; //TODO
 void loop() {
@@ -79,7 +125,13 @@ void loop() {
 	log_cycle();
 #endif
 
-	eb_fire(BusEvent::CYCLE);
+	eb_drain();
+	sc_dispatch();
+	ee_flush();
+
+#if ENABLE_IDLE_SLEEP
+	idle();
+#endif
 
 	//TODO
 //	if (util_ms() - lms > 10000) {
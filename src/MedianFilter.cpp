@@ -0,0 +1,149 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MedianFilter.h"
+
+static_assert(TS_MEDIAN_WINDOW % 2 == 1 && TS_MEDIAN_WINDOW < 128, "TS_MEDIAN_WINDOW must be odd and below 128");
+
+MedianFilter::MedianFilter(FilterStage input) :
+		TempFilter(input), heap(heapBuf + N / 2), idx(0), count(0) {
+	clear();
+}
+
+void MedianFilter::clear() {
+	idx = 0;
+	count = 0;
+
+	// positions alternate between heaps: 0, -1, 1, -2, 2 ... so that partially filled window stays balanced
+	for (uint8_t dIdx = 0; dIdx < N; dIdx++) {
+		int8_t p = ((dIdx + 1) / 2) * ((dIdx & 1) ? -1 : 1);
+		data[dIdx] = 0;
+		pos[dIdx] = p;
+		heap[p] = dIdx;
+	}
+}
+
+uint8_t MedianFilter::size() {
+	return count;
+}
+
+temp_t MedianFilter::add(temp_t sample) {
+	boolean filling = count < N;
+	int8_t p = pos[idx];
+	temp_t old = data[idx];
+	data[idx] = sample;
+	idx = (idx + 1) % N;
+	if (filling) {
+		count++;
+	}
+
+	if (p > 0) {
+		// sample is in min-heap
+		if (!filling && old < sample) {
+			minSortDown(p * 2);
+		} else if (minSortUp(p)) {
+			maxSortDown(-1);
+		}
+
+	} else if (p < 0) {
+		// sample is in max-heap
+		if (!filling && sample < old) {
+			maxSortDown(p * 2);
+		} else if (maxSortUp(p)) {
+			minSortDown(1);
+		}
+
+	} else {
+		// sample replaced median
+		if (maxCount() > 0) {
+			maxSortDown(-1);
+		}
+		if (minCount() > 0) {
+			minSortDown(1);
+		}
+	}
+	return median();
+}
+
+temp_t MedianFilter::median() {
+	temp_t med = data[heap[0]];
+	if (count > 0 && (count & 1) == 0) {
+		med = ((int32_t) med + data[heap[-1]]) / 2;
+	}
+	return med;
+}
+
+inline uint8_t MedianFilter::minCount() {
+	return count == 0 ? 0 : (count - 1) / 2;
+}
+
+inline uint8_t MedianFilter::maxCount() {
+	return count / 2;
+}
+
+inline boolean MedianFilter::less(int8_t i, int8_t j) {
+	return data[heap[i]] < data[heap[j]];
+}
+
+inline boolean MedianFilter::swapIfLess(int8_t i, int8_t j) {
+	if (!less(i, j)) {
+		return false;
+	}
+	uint8_t tmp = heap[i];
+	heap[i] = heap[j];
+	heap[j] = tmp;
+	pos[heap[i]] = i;
+	pos[heap[j]] = j;
+	return true;
+}
+
+/* Sifts down starting with child #i of position i/2, position 1 is the only child of the median. */
+void MedianFilter::minSortDown(int8_t i) {
+	for (; i <= minCount(); i *= 2) {
+		if (i > 1 && i < minCount() && less(i + 1, i)) {
+			i++;
+		}
+		if (!swapIfLess(i, i / 2)) {
+			break;
+		}
+	}
+}
+
+void MedianFilter::maxSortDown(int8_t i) {
+	for (; i >= -maxCount(); i *= 2) {
+		if (i < -1 && i > -maxCount() && less(i, i - 1)) {
+			i--;
+		}
+		if (!swapIfLess(i / 2, i)) {
+			break;
+		}
+	}
+}
+
+/* Returns true when sample has reached the median. */
+boolean MedianFilter::minSortUp(int8_t i) {
+	while (i > 0 && swapIfLess(i, i / 2)) {
+		i /= 2;
+	}
+	return i == 0;
+}
+
+boolean MedianFilter::maxSortUp(int8_t i) {
+	while (i < 0 && swapIfLess(i / 2, i)) {
+		i /= 2;
+	}
+	return i == 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MEDIANFILTER_H_
+#define MEDIANFILTER_H_
+
+#include "Arduino.h"
+#include "Config.h"
+#include "Temperature.h"
+#include "TempFilter.h"
+
+/**
+ * Median of the last #TS_MEDIAN_WINDOW samples, updated with each sample in O(log n).
+ *
+ * Samples are kept in a ring buffer and indexed by two heaps sharing a single array around its middle: max-heap with
+ * lower half on negative positions, min-heap with upper half on positive ones, and median on position 0. The oldest
+ * sample is replaced in place by the new one, which is then sifted up or down within its heap and, if it crosses the
+ * median, into the other one.
+ */
+class MedianFilter: public TempFilter {
+public:
+	MedianFilter(FilterStage input);
+
+	/** Adds sample replacing the oldest one once window is full, and returns median. */
+	temp_t add(temp_t sample);
+
+	/** Median of samples added so far, average of two middle ones while amount of them is even. */
+	temp_t median();
+
+	/** Amount of samples in the window. */
+	uint8_t size();
+
+	void clear();
+
+private:
+	const static uint8_t N = TS_MEDIAN_WINDOW;
+
+	/* Samples in order of arrival, #idx points to the oldest one. */
+	temp_t data[N];
+
+	/* Heap position of each sample from #data. */
+	int8_t pos[N];
+
+	/* Heap positions from -N/2 to N/2 mapped to #data indexes, #heap points to the middle of #heapBuf. */
+	uint8_t heapBuf[N];
+	uint8_t* const heap;
+
+	uint8_t idx;
+	uint8_t count;
+
+	inline uint8_t minCount();
+	inline uint8_t maxCount();
+	inline boolean less(int8_t i, int8_t j);
+	inline boolean swapIfLess(int8_t i, int8_t j);
+	void minSortDown(int8_t i);
+	void maxSortDown(int8_t i);
+	boolean minSortUp(int8_t i);
+	boolean maxSortUp(int8_t i);
+};
+
+#endif /* MEDIANFILTER_H_ */
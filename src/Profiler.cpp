@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Profiler.h"
+
+#if ENABLE_PROFILER
+
+#include "Scheduler.h"
+#include "EventBus.h"
+#include "ArdLogSetup.h"
+
+#ifdef HOST_BUILD
+#include "Host.h"
+#endif
+
+const static uint8_t KINDS = 2;
+static ProfileStats stats[KINDS][EB_LISTENERS_AMOUNT];
+
+class DumpTask: public Task {
+public:
+	uint32_t run() {
+		pr_dump();
+		return PR_DUMP_MS;
+	}
+};
+static DumpTask dumpTask;
+
+static inline uint8_t bucket(uint32_t us) {
+	uint8_t bIdx = 0;
+	while (us >= 8 && bIdx < PR_BUCKETS - 1) {
+		us >>= 3;
+		bIdx++;
+	}
+	return bIdx;
+}
+
+uint32_t pr_us() {
+#ifdef HOST_BUILD
+	return (uint32_t) (host_hrNs() / 1000);
+#else
+	return micros();
+#endif
+}
+
+void pr_record(ProfileKind kind, ListenerSlot slot, uint32_t startUs) {
+	if (slot == ListenerSlot::AMOUNT) {
+		return;
+	}
+	uint32_t us = pr_us() - startUs;
+	ProfileStats* st = &stats[static_cast<uint8_t>(kind)][static_cast<uint8_t>(slot)];
+	st->count++;
+	st->totalUs += us;
+	if (us > st->maxUs) {
+		st->maxUs = us;
+	}
+	uint16_t* hist = &st->hist[bucket(us)];
+	if (*hist < 0xFFFF) {
+		(*hist)++;
+	}
+}
+
+const ProfileStats* pr_stats(ProfileKind kind, ListenerSlot slot) {
+	return &stats[static_cast<uint8_t>(kind)][static_cast<uint8_t>(slot)];
+}
+
+void pr_clear() {
+	memset(stats, 0, sizeof(stats));
+}
+
+void pr_dump() {
+	for (uint8_t kIdx = 0; kIdx < KINDS; kIdx++) {
+		for (uint8_t sIdx = 0; sIdx < EB_LISTENERS_AMOUNT; sIdx++) {
+			ProfileStats* st = &stats[kIdx][sIdx];
+			if (st->count == 0) {
+				continue;
+			}
+			Serial.print(F("PR "));
+			Serial.print(kIdx == 0 ? 'E' : 'T');
+			Serial.print(' ');
+			Serial.print(sIdx);
+			Serial.print(' ');
+			Serial.print(st->count);
+			Serial.print(' ');
+			Serial.print(st->totalUs);
+			Serial.print(' ');
+			Serial.print(st->maxUs);
+			for (uint8_t bIdx = 0; bIdx < PR_BUCKETS; bIdx++) {
+				Serial.print(' ');
+				Serial.print(st->hist[bIdx]);
+			}
+			Serial.println();
+		}
+	}
+}
+
+void pr_setup() {
+	Serial.begin(SERIAL_SPEED);
+	sc_schedule(&dumpTask, PR_DUMP_MS);
+}
+
+#endif /* ENABLE_PROFILER */
@@ -0,0 +1,63 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include "Arduino.h"
+#include "ArdLog.h"
+#include "Config.h"
+
+/**
+ * Execution time of each component, enabled by #ENABLE_PROFILER. Time is measured separately for event delivery
+ * (BusListener#onEvent()) and for execution by the scheduler (Task#run()), and attributed to #ListenerSlot of the
+ * component.
+ */
+#if ENABLE_PROFILER
+
+/** Histogram bucket n counts executions taking [8^n, 8^(n+1)) us, first one below 8us, last one everything longer. */
+const static uint8_t PR_BUCKETS = 8;
+
+typedef struct {
+	uint32_t count;
+	uint32_t totalUs;
+	uint32_t maxUs;
+	uint16_t hist[PR_BUCKETS];
+} ProfileStats;
+
+enum class ProfileKind : uint8_t {
+	EVENT = 0, TASK = 1
+};
+
+/** Time stamp in microseconds to be passed to #pr_record(). */
+uint32_t pr_us();
+
+/** Records execution that has started at #startUs, slot #ListenerSlot::AMOUNT is not recorded. */
+void pr_record(ProfileKind kind, ListenerSlot slot, uint32_t startUs);
+
+const ProfileStats* pr_stats(ProfileKind kind, ListenerSlot slot);
+
+void pr_clear();
+
+/** Prints all stats over serial, one line per component and kind: PR kind slot count total max hist... */
+void pr_dump();
+
+/** Schedules #pr_dump() every #PR_DUMP_MS. */
+void pr_setup();
+
+#endif /* ENABLE_PROFILER */
+
+#endif /* PROFILER_H_ */
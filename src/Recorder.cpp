@@ -0,0 +1,90 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Recorder.h"
+
+#if ENABLE_RECORDER
+
+#include "ArdLogSetup.h"
+
+static_assert((REC_SIZE & (REC_SIZE - 1)) == 0, "REC_SIZE has to be power of two");
+const static uint16_t REC_MASK = REC_SIZE - 1;
+static RecEntry entries[REC_SIZE];
+static uint32_t total = 0;
+static temp_t lastTemp = 0x7FFF;
+
+static void record(uint8_t type, uint8_t sourceId, int16_t value) {
+	RecEntry* entry = &entries[total & REC_MASK];
+	entry->ms = util_ms();
+	entry->type = type;
+	entry->sourceId = sourceId;
+	entry->value = value;
+	total++;
+}
+
+void rec_setup() {
+	Serial.begin(SERIAL_SPEED);
+	record(REC_BOOT, 0, 0);
+}
+
+void rec_event(const BusMsg* msg) {
+	record(static_cast<uint8_t>(msg->event), msg->sourceId, msg->data.value);
+}
+
+void rec_temp(temp_t temp) {
+	if (temp == lastTemp) {
+		return;
+	}
+	lastTemp = temp;
+	record(REC_TEMP, DEVICE_ID_TEMP_SENSOR, temp);
+}
+
+uint16_t rec_size() {
+	return total < REC_SIZE ? total : REC_SIZE;
+}
+
+uint32_t rec_total() {
+	return total;
+}
+
+const RecEntry* rec_get(uint16_t idx) {
+	return &entries[(total - rec_size() + idx) & REC_MASK];
+}
+
+void rec_dump() {
+	uint16_t size = rec_size();
+	Serial.print(F("RC BEGIN "));
+	Serial.print(total);
+	Serial.print(' ');
+	Serial.print(size);
+	Serial.println();
+
+	for (uint16_t idx = 0; idx < size; idx++) {
+		const RecEntry* entry = rec_get(idx);
+		Serial.print(F("RC "));
+		Serial.print(entry->ms);
+		Serial.print(' ');
+		Serial.print(entry->type);
+		Serial.print(' ');
+		Serial.print(entry->sourceId);
+		Serial.print(' ');
+		Serial.print(entry->value);
+		Serial.println();
+	}
+	Serial.println(F("RC END"));
+}
+
+#endif /* ENABLE_RECORDER */
@@ -0,0 +1,79 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RECORDER_H_
+#define RECORDER_H_
+
+#include "Arduino.h"
+#include "ArdLog.h"
+#include "Config.h"
+#include "EventBus.h"
+
+/**
+ * Ring buffer of everything that happens on the device, enabled by #ENABLE_RECORDER: fired bus events (apart from
+ * CYCLE), changes of the temperature and end of setup(). Dumped trace can be replayed on the host by
+ * thermostat_replay.
+ */
+#if ENABLE_RECORDER
+
+/** Entry type for temperature change, value contains temperature read by TempSensor. */
+const static uint8_t REC_TEMP = 0xF0;
+
+/** Entry type marking end of setup(). */
+const static uint8_t REC_BOOT = 0xF1;
+
+typedef struct {
+	/** #util_ms() when entry has been recorded, for bus events it's the time when they were fired. */
+	uint32_t ms;
+
+	/** BusEvent or #REC_TEMP, #REC_BOOT. */
+	uint8_t type;
+
+	/** BusMsg#sourceId */
+	uint8_t sourceId;
+
+	/** BusMsg#data or temperature. */
+	int16_t value;
+} RecEntry;
+
+/** Records end of setup(). */
+void rec_setup();
+
+void rec_event(const BusMsg* msg);
+
+/** Records temperature if it's different from the last one. */
+void rec_temp(temp_t temp);
+
+/** Amount of entries in the buffer. */
+uint16_t rec_size();
+
+/** Amount of entries recorded since boot, if it's larger than #rec_size() the oldest ones have been overwritten. */
+uint32_t rec_total();
+
+/** Entry at #idx, 0 is the oldest one. */
+const RecEntry* rec_get(uint16_t idx);
+
+/**
+ * Prints the buffer over serial, oldest entry first:
+ * RC BEGIN <total> <size>
+ * RC <ms> <type> <sourceId> <value>
+ * RC END
+ */
+void rec_dump();
+
+#endif /* ENABLE_RECORDER */
+
+#endif /* RECORDER_H_ */
@@ -16,14 +16,14 @@
  */
 #include "RelayController.h"
 
-RelayController::RelayController(TempSensor* ts, int8_t tempSetPoint) :
-		tempSensor(ts), tempSetPoint(tempSetPoint) {
+RelayController::RelayController(TempSensor* ts, FilterStage stage, temp_t tempSetPoint) :
+		tempSensor(ts), tempSetPoint(tempSetPoint), stage(stage) {
 }
 
 RelayController::~RelayController() {
 }
 
-int8_t RelayController::getSetPoint() {
+temp_t RelayController::getSetPoint() {
 	return tempSetPoint;
 }
 
@@ -18,18 +18,27 @@
 #define RELAYCONTROLLER_H_
 
 #include "Relay.h"
+#include "TempSensor.h"
 
 class RelayController {
 
 public:
-	RelayController(TempSensor* tempSensor, int8_t tempSetPoint);
+	RelayController(TempSensor* tempSensor, FilterStage stage, temp_t tempSetPoint);
 	virtual ~RelayController();
 	virtual Relay::State execute() = 0;
-	int8_t getSetPoint();
+	temp_t getSetPoint();
 
 protected:
 	TempSensor* const tempSensor;
-	const int8_t tempSetPoint;
+	const temp_t tempSetPoint;
+
+	/** Temperature from the filter stage chosen for this controller. */
+	inline temp_t readTemp() {
+		return tempSensor->getFilteredTemp(stage);
+	}
+
+private:
+	const FilterStage stage;
 };
 
 #endif /* RELAYCONTROLLER_H_ */
@@ -17,7 +17,7 @@
 #include "RelayDriver.h"
 
 RelayDriver::RelayDriver(TempSensor* ts) :
-		tempSensor(ts), lastSwitchMs(0) {
+		Service(ListenerSlot::RELAY_DRIVER), tempSensor(ts), lastSwitchMs(0) {
 }
 
 void RelayDriver::init() {
@@ -25,7 +25,7 @@ void RelayDriver::init() {
 	initRelayHysteresisController(1, DIG_PIN_RELAY_1, RELAY_TEMP_SET_POINT_1);
 }
 
-void RelayDriver::initRelayHysteresisController(uint8_t relayId, uint8_t pin, int8_t tempSetPoint) {
+void RelayDriver::initRelayHysteresisController(uint8_t relayId, uint8_t pin, temp_t tempSetPoint) {
 	RelayData* relay = &relays[relayId];
 	relay->controller = new RelayHysteresisController(tempSensor, tempSetPoint);
 	relay->relay = new Relay(pin);
@@ -41,14 +41,17 @@ boolean RelayDriver::isOn(uint8_t relayId) {
 	return relays[relayId].relay->getState() == Relay::State::ON;
 }
 
-int8_t RelayDriver::getSetPoint(uint8_t relayId) {
+temp_t RelayDriver::getSetPoint(uint8_t relayId) {
 	return relays[relayId].controller->getSetPoint();
 }
 
-void RelayDriver::cycle() {
+uint32_t RelayDriver::cycle() {
 	for (uint8_t i = 0; i < RELAYS_AMOUNT; i++) {
 		executeRelay(i);
 	}
+
+	// controllers react on temperature, it does not change more often than it's being probed
+	return TS_PROBE_FREQ_MS;
 }
 
 inline void RelayDriver::executeRelay(uint8_t id) {
@@ -72,7 +75,9 @@ inline void RelayDriver::executeRelay(uint8_t id) {
 	rd.state = state;
 	rd.relay->onState(state);
 
-	eb_fire(state == Relay::State::ON ? BusEvent::RELAY_ON : BusEvent::RELAY_OFF, id);
+	BusMsg msg = eb_msg(state == Relay::State::ON ? BusEvent::RELAY_ON : BusEvent::RELAY_OFF, deviceId());
+	msg.data.relayId = id;
+	eb_post(&msg);
 }
 
 uint8_t RelayDriver::deviceId() {
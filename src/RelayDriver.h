@@ -31,7 +31,7 @@ public:
 	RelayDriver(TempSensor* ts);
 	~RelayDriver();
 	boolean isOn(uint8_t relayId);
-	int8_t getSetPoint(uint8_t relayId);
+	temp_t getSetPoint(uint8_t relayId);
 
 private:
 	typedef struct {
@@ -50,9 +50,9 @@ private:
 	/* In this method you can define your relay setup! */
 	void init();
 	uint8_t deviceId();
-	void cycle();
+	uint32_t cycle();
 	void initRelayData(RelayData* val);
-	void initRelayHysteresisController(uint8_t relayId, uint8_t pin, int8_t tempSetPoint);
+	void initRelayHysteresisController(uint8_t relayId, uint8_t pin, temp_t tempSetPoint);
 };
 
 #endif /* RELAYDRIVER_H_ */
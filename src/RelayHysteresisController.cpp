@@ -16,8 +16,8 @@
  */
 #include "RelayHysteresisController.h"
 
-RelayHysteresisController::RelayHysteresisController(TempSensor* ts, int8_t tempSetPoint) :
-		RelayController(ts, tempSetPoint), lastSwitchMs(0), state(Relay::State::OFF) {
+RelayHysteresisController::RelayHysteresisController(TempSensor* ts, temp_t tempSetPoint) :
+		RelayController(ts, RHC_FILTER_STAGE, tempSetPoint), lastSwitchMs(0), state(Relay::State::OFF) {
 }
 
 RelayHysteresisController::~RelayHysteresisController() {
@@ -31,7 +31,7 @@ Relay::State RelayHysteresisController::execute() {
 	}
 
 	Relay::State newState = Relay::State::NO_CHANGE;
-	int8_t temp = tempSensor->getQuickTemp();
+	temp_t temp = readTemp();
 
 	if (temp <= tempSetPoint) {
 		newState = Relay::State::OFF;
@@ -16,38 +16,39 @@
  */
 #include "RelayPidController.h"
 
-RelayPidController::RelayPidController(TempSensor* ts, int8_t tempSetPoint) :
-		RelayController(ts, tempSetPoint), iDerivationSum(0), dPrevDerivation(0) {
+RelayPidController::RelayPidController(TempSensor* ts, temp_t tempSetPoint) :
+		RelayController(ts, RPC_FILTER_STAGE, tempSetPoint), iDerivationSum(0), dPrevDerivation(0) {
 }
 
 RelayPidController::~RelayPidController() {
 }
 
-float RelayPidController::calculateP(float derivation) {
-	return RPC_AMP_P * derivation;
+int32_t RelayPidController::calculateP(temp_t derivation) {
+	return (int32_t) RPC_AMP_P * derivation / RPC_AMP_UNIT;
 }
 
-float RelayPidController::calculateI(float derivation) {
-	iDerivationSum += derivation;
-	return RPC_AMP_I * iDerivationSum;
+/* Sum is clamped, so that the integral part stays within #RPC_I_LIMIT and the sum never overflows. */
+int32_t RelayPidController::calculateI(temp_t derivation) {
+	const int32_t sumMax = (int32_t) RPC_I_LIMIT * RPC_AMP_UNIT / RPC_AMP_I;
+	iDerivationSum = constrain(iDerivationSum + derivation, -sumMax, sumMax);
+	return RPC_AMP_I * iDerivationSum / RPC_AMP_UNIT;
 }
 
-float RelayPidController::calculateD(float derivation) {
-	float d = RPC_AMP_D * (derivation - dPrevDerivation);
+int32_t RelayPidController::calculateD(temp_t derivation) {
+	int32_t d = (int32_t) RPC_AMP_D * (derivation - dPrevDerivation) / RPC_AMP_UNIT;
 	dPrevDerivation = derivation;
 	return d;
 }
 
 Relay::State RelayPidController::execute() {
-	float derivation = tempSetPoint - tempSensor->getTemp();
-	float valP = calculateP(derivation);
-	float valI = calculateI(derivation);
-	float valD = calculateD(derivation);
+	temp_t derivation = tempSetPoint - readTemp();
+	int32_t valP = calculateP(derivation);
+	int32_t valI = calculateI(derivation);
+	int32_t valD = calculateD(derivation);
 
-	float pid = valP + valI + valD;
+	int32_t pid = valP + valI + valD;
 
 	Relay::State state = pid < RPC_PID_SWITCH_THRESHOLD ? Relay::State::ON: Relay::State::OFF;
 
 	return state;
 }
-
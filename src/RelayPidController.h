@@ -22,17 +22,17 @@
 
 class RelayPidController : public RelayController {
 public:
-	RelayPidController(TempSensor* ts, int8_t tempSetPoint);
+	RelayPidController(TempSensor* ts, temp_t tempSetPoint);
 	virtual ~RelayPidController();
 	Relay::State execute();
 
 private:
-	float iDerivationSum;
-	float dPrevDerivation;
+	int32_t iDerivationSum;
+	temp_t dPrevDerivation;
 
-	float calculateP(float derivation);
-	float calculateI(float derivation);
-	float calculateD(float derivation);
+	int32_t calculateP(temp_t derivation);
+	int32_t calculateI(temp_t derivation);
+	int32_t calculateD(temp_t derivation);
 };
 
 #endif /* RELAYPIDCONTROLLER_H_ */
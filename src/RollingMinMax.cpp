@@ -0,0 +1,102 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "RollingMinMax.h"
+
+static_assert(ST_ROLLING_BUCKETS < 128, "ST_ROLLING_BUCKETS has to be below 128, sequence numbers are 8 bits");
+
+RollingMinMax::RollingMinMax() {
+	clear();
+}
+
+void RollingMinMax::clear() {
+	mins.front = 0;
+	mins.size = 0;
+	maxs.front = 0;
+	maxs.size = 0;
+	seq = 0;
+	bucketStartMs = 0;
+	bucketMin = 0;
+	bucketMax = 0;
+	empty = true;
+}
+
+void RollingMinMax::add(uint32_t ms, temp_t temp) {
+	if (empty) {
+		empty = false;
+		bucketStartMs = ms;
+		bucketMin = temp;
+		bucketMax = temp;
+		return;
+	}
+
+	uint32_t elapsedMs = ms - bucketStartMs;
+	if (elapsedMs >= BUCKET_MS) {
+		push(&mins, bucketMin, true);
+		push(&maxs, bucketMax, false);
+
+		// buckets without probes are skipped, after long enough break nothing remains in the window
+		uint32_t buckets = elapsedMs / BUCKET_MS;
+		if (buckets >= N) {
+			mins.size = 0;
+			maxs.size = 0;
+			buckets = N;
+		}
+		seq += buckets;
+		bucketStartMs += elapsedMs / BUCKET_MS * BUCKET_MS;
+		expire(&mins);
+		expire(&maxs);
+		bucketMin = temp;
+		bucketMax = temp;
+	} else {
+		bucketMin = min(bucketMin, temp);
+		bucketMax = max(bucketMax, temp);
+	}
+}
+
+temp_t RollingMinMax::getMin() {
+	return mins.size == 0 ? bucketMin : min(bucketMin, mins.val[mins.front]);
+}
+
+temp_t RollingMinMax::getMax() {
+	return maxs.size == 0 ? bucketMax : max(bucketMax, maxs.val[maxs.front]);
+}
+
+inline uint8_t RollingMinMax::back(Deque* dq) {
+	return (dq->front + dq->size - 1) % N;
+}
+
+inline void RollingMinMax::push(Deque* dq, temp_t val, boolean lower) {
+	while (dq->size > 0) {
+		temp_t last = dq->val[back(dq)];
+		if (lower ? last < val : last > val) {
+			break;
+		}
+		dq->size--;
+	}
+	uint8_t idx = (dq->front + dq->size) % N;
+	dq->seq[idx] = seq;
+	dq->val[idx] = val;
+	dq->size++;
+}
+
+inline void RollingMinMax::expire(Deque* dq) {
+	// the open bucket is one of N in the window
+	while (dq->size > 0 && (uint8_t) (seq - dq->seq[dq->front]) >= N) {
+		dq->front = (dq->front + 1) % N;
+		dq->size--;
+	}
+}
@@ -0,0 +1,73 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ROLLINGMINMAX_H_
+#define ROLLINGMINMAX_H_
+
+#include "Arduino.h"
+#include "Config.h"
+#include "Temperature.h"
+
+/**
+ * Min and max of the temperature over last #ST_ROLLING_MS. Probes are downsampled into #ST_ROLLING_BUCKETS buckets,
+ * min and max of the closed buckets are kept in monotonic deques: adding a bucket drops from the back all buckets that
+ * can no longer be the extreme, and buckets older than the window are dropped from the front. Each bucket is added and
+ * removed once, so update is O(1) amortised, and the front of the deque is the result.
+ */
+class RollingMinMax {
+public:
+	RollingMinMax();
+
+	/** Adds probe taken at given time, time cannot go backwards. */
+	void add(uint32_t ms, temp_t temp);
+
+	/** Both are only valid after first #add(). */
+	temp_t getMin();
+	temp_t getMax();
+
+	void clear();
+
+private:
+	const static uint8_t N = ST_ROLLING_BUCKETS;
+	const static uint32_t BUCKET_MS = ST_ROLLING_MS / ST_ROLLING_BUCKETS;
+
+	/* Ring buffer of closed buckets, #seq of them grows from front to back. */
+	typedef struct {
+		uint8_t seq[N];
+		temp_t val[N];
+		uint8_t front;
+		uint8_t size;
+	} Deque;
+
+	Deque mins;
+	Deque maxs;
+
+	/* Sequence number of the open bucket, it wraps, but deques never hold more than #N buckets. */
+	uint8_t seq;
+	uint32_t bucketStartMs;
+	temp_t bucketMin;
+	temp_t bucketMax;
+	boolean empty;
+
+	/* Appends closed bucket to the back, after removing those that are not lower (#lower) or not higher than #val. */
+	inline void push(Deque* dq, temp_t val, boolean lower);
+
+	/* Removes buckets that have left the window from the front. */
+	inline void expire(Deque* dq);
+	inline uint8_t back(Deque* dq);
+};
+
+#endif /* ROLLINGMINMAX_H_ */
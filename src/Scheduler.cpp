@@ -0,0 +1,188 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Scheduler.h"
+
+/* Each component owns at most one task, one more is left for tasks without owner, like the profiler dump. */
+const static uint8_t TASKS_MAX = static_cast<uint8_t>(ListenerSlot::AMOUNT) + 1;
+const static uint8_t IDX_NONE = 0xFF;
+
+/* Task that has been executed by the running sc_dispatch() and goes back to the queue when it's done. */
+const static uint8_t IDX_DEFERRED = 0xFE;
+
+/** Binary min-heap of tasks ordered by due time. */
+class TaskQueue {
+public:
+	static Task* tasks[TASKS_MAX];
+	static uint8_t size;
+
+	/* Compares time stamps so that it works when util_ms() overflows. */
+	static inline boolean before(uint32_t ms1, uint32_t ms2) {
+		return (int32_t) (ms1 - ms2) < 0;
+	}
+
+	static inline void place(Task* task, uint8_t idx) {
+		tasks[idx] = task;
+		task->qIdx = idx;
+	}
+
+	static void up(uint8_t idx) {
+		Task* task = tasks[idx];
+		while (idx > 0) {
+			uint8_t parent = (idx - 1) / 2;
+			if (!before(task->dueMs, tasks[parent]->dueMs)) {
+				break;
+			}
+			place(tasks[parent], idx);
+			idx = parent;
+		}
+		place(task, idx);
+	}
+
+	static void down(uint8_t idx) {
+		Task* task = tasks[idx];
+		while (true) {
+			uint8_t child = idx * 2 + 1;
+			if (child >= size) {
+				break;
+			}
+			if (child + 1 < size && before(tasks[child + 1]->dueMs, tasks[child]->dueMs)) {
+				child++;
+			}
+			if (!before(tasks[child]->dueMs, task->dueMs)) {
+				break;
+			}
+			place(tasks[child], idx);
+			idx = child;
+		}
+		place(task, idx);
+	}
+
+	static void remove(Task* task) {
+		uint8_t idx = task->qIdx;
+		task->qIdx = IDX_NONE;
+		size--;
+		if (idx == size) {
+			return;
+		}
+		Task* last = tasks[size];
+		place(last, idx);
+		up(idx);
+		down(last->qIdx);
+	}
+
+	static boolean insert(Task* task, uint32_t dueMs) {
+		if (task->qIdx == IDX_DEFERRED) {
+			task->qIdx = IDX_NONE;
+		} else if (task->qIdx != IDX_NONE) {
+			remove(task);
+		}
+		if (size == TASKS_MAX) {
+#if LOG
+			log(F("SC FULL"));
+#endif
+			return false;
+		}
+		task->dueMs = dueMs;
+		place(task, size++);
+		up(task->qIdx);
+		return true;
+	}
+};
+
+Task* TaskQueue::tasks[TASKS_MAX];
+uint8_t TaskQueue::size = 0;
+
+Task::Task() :
+		dueMs(0), qIdx(IDX_NONE), slot(ListenerSlot::AMOUNT) {
+}
+
+Task::Task(ListenerSlot slot) :
+		dueMs(0), qIdx(IDX_NONE), slot(slot) {
+}
+
+Task::~Task() {
+	sc_cancel(this);
+}
+
+boolean sc_schedule(Task* task, uint32_t delayMs) {
+	return TaskQueue::insert(task, util_ms() + delayMs);
+}
+
+void sc_cancel(Task* task) {
+	if (task->qIdx == IDX_DEFERRED) {
+		task->qIdx = IDX_NONE;
+	} else if (task->qIdx != IDX_NONE) {
+		TaskQueue::remove(task);
+	}
+}
+
+static boolean contains(Task** tasks, uint8_t amount, Task* task) {
+	for (uint8_t idx = 0; idx < amount; idx++) {
+		if (tasks[idx] == task) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void sc_dispatch() {
+	uint32_t ms = util_ms();
+
+	// executed tasks go back to the queue after the loop, so that 0 delay does not execute them again in it
+	Task* executed[TASKS_MAX];
+	uint8_t executedCnt = 0;
+	while (TaskQueue::size > 0) {
+		Task* task = TaskQueue::tasks[0];
+		if (TaskQueue::before(ms, task->dueMs)) {
+			break;
+		}
+		TaskQueue::remove(task);
+
+		// scheduled again while running, by itself or by another task
+		if (contains(executed, executedCnt, task)) {
+			task->qIdx = IDX_DEFERRED;
+			continue;
+		}
+#if ENABLE_PROFILER
+		uint32_t startUs = pr_us();
+#endif
+		uint32_t delayMs = task->run();
+#if ENABLE_PROFILER
+		pr_record(ProfileKind::TASK, task->slot, startUs);
+#endif
+		executed[executedCnt++] = task;
+		if (task->qIdx == IDX_NONE && delayMs != SC_NEVER) {
+			task->dueMs = ms + delayMs;
+			task->qIdx = IDX_DEFERRED;
+		}
+	}
+	for (uint8_t eIdx = 0; eIdx < executedCnt; eIdx++) {
+		Task* task = executed[eIdx];
+		if (task->qIdx == IDX_DEFERRED) {
+			TaskQueue::insert(task, task->dueMs);
+		}
+	}
+}
+
+uint32_t sc_nextMs() {
+	if (TaskQueue::size == 0) {
+		return SC_NEVER;
+	}
+	uint32_t dueMs = TaskQueue::tasks[0]->dueMs;
+	uint32_t ms = util_ms();
+	return TaskQueue::before(ms, dueMs) ? dueMs - ms : 0;
+}
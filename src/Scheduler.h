@@ -0,0 +1,79 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include "Arduino.h"
+#include "ArdLog.h"
+#include "Util.h"
+#include "Config.h"
+#include "Profiler.h"
+
+/** Returned by Task#run() when task should not be executed again until it gets scheduled. */
+const static uint32_t SC_NEVER = 0xFFFFFFFF;
+
+/**
+ * Piece of work executed by the scheduler at given time. Instead of checking on every loop whether it's time to do
+ * something, task tells the scheduler when it should be called next time.
+ */
+class Task {
+public:
+	/** Executes task and returns delay in milliseconds to the next execution or #SC_NEVER. */
+	virtual uint32_t run() = 0;
+
+protected:
+	Task();
+
+	/** #slot - component owning this task, the profiler attributes execution time to it. */
+	Task(ListenerSlot slot);
+	virtual ~Task();
+
+private:
+	friend class TaskQueue;
+	friend void sc_cancel(Task* task);
+	friend void sc_dispatch();
+	friend uint32_t sc_nextMs();
+
+	/* util_ms() when task is due. */
+	uint32_t dueMs;
+
+	/* position in the queue, 0xFF when not scheduled, 0xFE when it waits for the end of sc_dispatch(). */
+	uint8_t qIdx;
+
+	const ListenerSlot slot;
+};
+
+/**
+ * Schedules task to be executed #delayMs from now. Task that has been already scheduled will be moved. Returns false
+ * when the queue is full, it has a place for one task of each ListenerSlot and one more.
+ */
+boolean sc_schedule(Task* task, uint32_t delayMs);
+
+/** Removes task from the schedule. */
+void sc_cancel(Task* task);
+
+/**
+ * Executes all tasks that are due and schedules them again by the delay returned from Task#run(). Each task
+ * executes at most once per call, also when it returns 0 or schedules itself, it runs again by the next call.
+ * Should be called once per loop().
+ */
+void sc_dispatch();
+
+/** Milliseconds until the next task is due, 0 if it's due already, #SC_NEVER if nothing is scheduled. */
+uint32_t sc_nextMs();
+
+#endif /* SCHEDULER_H_ */
@@ -16,37 +16,15 @@
  */
 #include "Service.h"
 
-Service::Service() :
-		enabled(true), serviceBusListener(this) {
+Service::Service(ListenerSlot slot) :
+		Task(slot) {
+	sc_schedule(this, 0);
 }
 
 Service::~Service() {
 
 }
 
-// ############### ServiceBusListener ###############
-void Service::ServiceBusListener::onEvent(BusEvent event, va_list ap) {
-	if (eb_inGroup(event, BusEventGroup::SERVICE)) {
-		if (event == BusEvent::SERVICE_RESUME) {
-			service->enabled = true;
-
-		} else if (event == BusEvent::SERVICE_SUSPEND && service->enabled) {
-			service->enabled = false;
-		}
-#if LOG
-		log(F("SE %s - %d"), service->enabled ? "E" : "D", service->deviceId());
-#endif
-
-	} else if (service->enabled && event == BusEvent::CYCLE) {
-		service->cycle();
-	}
-}
-
-uint8_t Service::ServiceBusListener::listenerId() {
-	return service->deviceId() + 100;
+uint32_t Service::run() {
+	return cycle();
 }
-
-Service::ServiceBusListener::ServiceBusListener(Service* service) :
-		service(service) {
-}
-
@@ -20,32 +20,27 @@
 #include "Arduino.h"
 #include "EventBus.h"
 #include "Initializable.h"
+#include "Scheduler.h"
 
-class Service: public Initializable {
+/**
+ * Service is being executed by the scheduler - first time on the first loop() after creation, and later after delay
+ * returned by #cycle(). Service must not block, longer operations are split over several executions.
+ */
+class Service: public Initializable, public Task {
 
 public:
-	Service();
+	Service(ListenerSlot slot);
 	virtual ~Service();
 
-
 protected:
-	virtual void cycle() = 0;
+	/** Executes service and returns delay in milliseconds to the next execution. */
+	virtual uint32_t cycle() = 0;
 
 	/** Range: 1-99 */
 	virtual uint8_t deviceId() = 0;
 
 private:
-	class ServiceBusListener: public BusListener {
-	public:
-		ServiceBusListener(Service* service);
-	private:
-		void onEvent(BusEvent event, va_list ap);
-		uint8_t listenerId();
-		Service* service;
-	};
-
-	boolean enabled;
-	ServiceBusListener serviceBusListener;
+	uint32_t run();
 };
 
 #endif /* SERVICE_H_ */
@@ -17,42 +17,37 @@
 #include "ServiceSuspender.h"
 
 ServiceSuspender::ServiceSuspender() :
-		suspendStart(0) {
+		BusListener(ListenerSlot::SUSPENDER, eb_mask(BusEventGroup::BUTTON) | eb_mask(BusEvent::SERVICE_RESUME)), Task(
+				ListenerSlot::SUSPENDER), suspendStart(0) {
 }
 
-void ServiceSuspender::onEvent(BusEvent event, va_list ap) {
-	if (event == BusEvent::CYCLE) {
-		cycle();
-	} else if (eb_inGroup(event, BusEventGroup::BUTTON)) {
+void ServiceSuspender::onEvent(const BusMsg* msg) {
+	if (eb_inGroup(msg->event, BusEventGroup::BUTTON)) {
 
 		if (suspendStart == 0) {
 #if LOG
 			log(F("SU SU"));
 #endif
-			eb_fire(BusEvent::SERVICE_SUSPEND);
+			eb_post(BusEvent::SERVICE_SUSPEND);
 		}
 
 		suspendStart = util_ms();
+		sc_schedule(this, DISP_SHOW_INFO_MS);
 
-	} else if (event == BusEvent::SERVICE_RESUME) {
+	} else if (msg->event == BusEvent::SERVICE_RESUME) {
 #if LOG
 		log(F("SU D RS"));
 #endif
 		suspendStart = 0;
+		sc_cancel(this);
 	}
 }
 
-uint8_t ServiceSuspender::listenerId() {
-	return LISTENER_ID_SUSPENDER;
-}
-
-inline void ServiceSuspender::cycle() {
-
-	if (suspendStart != 0 && util_ms() - suspendStart >= DISP_SHOW_INFO_MS) {
+uint32_t ServiceSuspender::run() {
 #if LOG
-		log(F("SU RS"));
+	log(F("SU RS"));
 #endif
-		eb_fire(BusEvent::SERVICE_RESUME);
-		suspendStart = 0;
-	}
+	eb_post(BusEvent::SERVICE_RESUME);
+	suspendStart = 0;
+	return SC_NEVER;
 }
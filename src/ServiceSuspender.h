@@ -22,14 +22,18 @@
 #include "TempSensor.h"
 #include "Util.h"
 #include "EventBus.h"
+#include "Scheduler.h"
 
-class ServiceSuspender: public BusListener {
+/**
+ * Marks user interaction: fires SERVICE_SUSPEND on the first button press and SERVICE_RESUME #DISP_SHOW_INFO_MS after
+ * the last one. Services keep running in between, since none of them blocks.
+ */
+class ServiceSuspender: public BusListener, public Task {
 public:
 	ServiceSuspender();
 private:
-	inline void cycle();
-	void onEvent(BusEvent event, va_list ap);
-	uint8_t listenerId();
+	uint32_t run();
+	void onEvent(const BusMsg* msg);
 
 	uint32_t suspendStart;
 };
@@ -18,14 +18,36 @@
 #define STATSDATA_H_
 
 #include "Config.h"
+#include "Temperature.h"
 
 typedef struct {
-	int8_t avg;
-	int8_t min;
-	int8_t max;
-	uint8_t day; // day number in history. 0 - now, 1 - yesterday, 2 - before yesterday, and so on.
+	temp_t avg;
+	temp_t min;
+	temp_t max;
+	uint16_t day; // entry number in history of its tier. For days: 0 - now, 1 - yesterday, 2 - before yesterday, and so on.
 } Temp;
 
+/** Running avg/min/max of a tier that has not finished yet, as it gets stored in EEPROM. */
+typedef struct {
+	int32_t sum;
+	uint16_t count;
+	temp_t min;
+	temp_t max;
+
+	/* Time since the entry has started, the clock starts from 0 after reboot. */
+	uint32_t elapsedMs;
+} TierCheckpoint;
+
+typedef struct {
+	TierCheckpoint day;
+	TierCheckpoint week;
+} StatsCheckpoint;
+
+/** Resolution of statistics, each tier is rolled up from the previous one. */
+enum class StatsTier : uint8_t {
+	MINUTE, HOUR, DAY, WEEK, AMOUNT
+};
+
 typedef struct {
 	uint8_t size;
 	boolean full;
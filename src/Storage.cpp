@@ -18,90 +18,390 @@
 #include "StatsData.h"
 
 Storage::Storage() :
-		dh_days(0) {
-	if (EEPROM.read(EIDX_INIT_BYTE) != INIT_BYTE) {
+		days( { EIDX_DAYS_START, DAY_CAPACITY, 0, 0, SEQ_EMPTY }), weeks( { EIDX_WEEKS_START,
+				ST_WEEK_HISTORY_SIZE, 0, 0, SEQ_EMPTY }), cache { NULL, 0, { } }, cpSeq(0) {
+	if (!sc_valid()) {
 		dh_clear();
+	} else {
+		h_load(&days);
+		h_load(&weeks);
+		StatsCheckpoint checkpoint;
+		for (uint8_t slot = 0; slot < ST_CHECKPOINT_SLOTS; slot++) {
+			uint16_t seq = cp_readSeq(slot);
+			if (seq != 0 && (cpSeq == 0 || (int16_t) (seq - cpSeq) > 0) && cp_read(slot, seq, &checkpoint)) {
+				cpSeq = seq;
+			}
+		}
 	}
 }
 
 Storage::~Storage() {
 }
 
-inline uint8_t Storage::dh_eIdx(uint8_t dIdx) {
-	uint8_t eIdx = EIDX_SIZE + dIdx * TEMP_SIZE;
-	return eIdx;
+uint8_t Storage::sc_header(uint8_t* header) {
+	header[0] = SCHEMA_MAGIC;
+	header[1] = SCHEMA_VERSION;
+	header[2] = DAY_CAPACITY & 0xFF;
+	header[3] = DAY_CAPACITY >> 8;
+	header[4] = ST_WEEK_HISTORY_SIZE;
+	header[5] = ST_CHECKPOINT_SLOTS;
+	header[6] = CP_SIZE;
+	uint8_t crc = 0;
+	for (uint8_t bIdx = 0; bIdx < EIDX_SIZE - 1; bIdx++) {
+		crc = util_crc8(crc, header[bIdx]);
+	}
+	return crc;
 }
 
-inline void Storage::dh_dShift() {
-	uint8_t minEidx = dh_eIdx(0);
-	uint8_t maxEidx = dh_eIdx(dh_days) - 1;
-
+boolean Storage::sc_valid() {
+	uint8_t header[EIDX_SIZE];
+	header[EIDX_SIZE - 1] = sc_header(header);
+	for (uint8_t bIdx = 0; bIdx < EIDX_SIZE; bIdx++) {
+		if (ee_read(EIDX_SCHEMA + bIdx) != header[bIdx]) {
 #if LOG
-	log(F("ST SD %d %d"), minEidx, maxEidx);
+			log(F("ST SCH %u"), bIdx);
 #endif
+			return false;
+		}
+	}
+	return true;
+}
 
-	for (uint8_t eIdx = maxEidx; eIdx >= minEidx; eIdx--) {
-		uint8_t val = EEPROM.read(eIdx);
-		EEPROM.write(eIdx + TEMP_SIZE, val);
+void Storage::sc_store() {
+	uint8_t header[EIDX_SIZE];
+	header[EIDX_SIZE - 1] = sc_header(header);
+	for (uint8_t bIdx = 0; bIdx < EIDX_SIZE; bIdx++) {
+		ee_write(EIDX_SCHEMA + bIdx, header[bIdx]);
 	}
 }
 
-inline uint8_t Storage::dh_eRead(Temp* temp, uint8_t eIdx) {
-	temp->avg = EEPROM.read(eIdx++);
-	temp->min = EEPROM.read(eIdx++);
-	temp->max = EEPROM.read(eIdx++);
-	return eIdx;
+inline uint16_t Storage::h_slotEIdx(History* history, uint16_t slot) {
+	return history->eIdxStart + slot * SLOT_SIZE;
 }
 
-inline uint8_t Storage::dh_eStore(Temp* temp, uint8_t eIdx) {
-	EEPROM.write(eIdx++, temp->avg);
-	EEPROM.write(eIdx++, temp->min);
-	EEPROM.write(eIdx++, temp->max);
-	return eIdx;
+inline uint16_t Storage::h_slot(History* history, uint16_t hIdx) {
+	return (history->head + history->capacity - hIdx) % history->capacity;
 }
 
-void Storage::dh_store(Temp* temp) {
+inline uint16_t Storage::h_readSeq(History* history, uint16_t slot) {
+	uint16_t eIdx = h_slotEIdx(history, slot);
+	return ee_read(eIdx) | (ee_read(eIdx + 1) << 8);
+}
+
+inline void Storage::h_storeSeq(History* history, uint16_t slot, uint16_t seq) {
+	uint16_t eIdx = h_slotEIdx(history, slot);
+	ee_write(eIdx, seq & 0xFF);
+	ee_write(eIdx + 1, seq >> 8);
+}
+
+inline uint8_t Storage::h_crc(uint16_t seq, Temp* temp) {
+	uint8_t crc = util_crc8(0, seq & 0xFF);
+	crc = util_crc8(crc, seq >> 8);
+	temp_t vals[] = { temp->avg, temp->min, temp->max };
+	for (uint8_t vIdx = 0; vIdx < 3; vIdx++) {
+		crc = util_crc8(crc, vals[vIdx] & 0xFF);
+		crc = util_crc8(crc, (vals[vIdx] >> 8) & 0xFF);
+	}
+	return crc;
+}
+
+boolean Storage::h_valid(History* history, uint16_t slot) {
+	uint16_t seq = h_readSeq(history, slot);
+	if (seq == SEQ_EMPTY) {
+		return false;
+	}
+	Temp temp;
+	uint16_t eIdx = h_eRead(&temp, h_slotEIdx(history, slot) + 2);
+	return ee_read(eIdx) == h_crc(seq, &temp);
+}
+
+inline uint16_t Storage::h_nextSeq(uint16_t seq) {
+	return seq == 0xFFFF ? 1 : seq + 1;
+}
+
+inline uint16_t Storage::h_prevSeq(uint16_t seq) {
+	return seq == 1 ? 0xFFFF : seq - 1;
+}
+
+/*
+ * The most recent entry is the one that is not followed by its next sequence number. Capacity is far below 0xFFFF, so
+ * that the sequence numbers in the log never repeat. Only the newest candidate that passes CRC is taken, so that slot
+ * torn by power loss is skipped. Entries in between are consecutive, only the oldest one could have been torn - when
+ * the log is full, torn slot is next to the most recent one.
+ */
+void Storage::h_load(History* history) {
+	history->size = 0;
+	history->head = 0;
+	history->seq = SEQ_EMPTY;
+	uint16_t nextSeq = h_readSeq(history, 0);
+	for (uint16_t slot = history->capacity; slot > 0; slot--) {
+		uint16_t seq = h_readSeq(history, slot - 1);
+		if (seq != SEQ_EMPTY && nextSeq != h_nextSeq(seq)
+				&& (history->seq == SEQ_EMPTY || (int16_t) (seq - history->seq) > 0) && h_valid(history, slot - 1)) {
+			history->head = slot - 1;
+			history->seq = seq;
+		}
+		nextSeq = seq;
+	}
+	if (history->seq == SEQ_EMPTY) {
+		return;
+	}
+
+	// go back as long as sequence numbers are consecutive
+	uint16_t seq = history->seq;
+	do {
+		history->size++;
+		seq = h_prevSeq(seq);
+	} while (history->size < history->capacity
+			&& h_readSeq(history, (history->head + history->capacity - history->size) % history->capacity) == seq);
+
+	if (history->size > 1 && !h_valid(history, h_slot(history, history->size - 1))) {
+		history->size--;
+	}
+
 #if LOG
-	log(F("ST WD(%d) %d,%d,%d"), dh_days, temp->min, temp->max, temp->avg);
+	log(F("ST HL %u %u %u"), history->head, history->seq, history->size);
 #endif
+}
+
+void Storage::h_clear(History* history) {
+	for (uint16_t slot = 0; slot < history->capacity; slot++) {
+		h_storeSeq(history, slot, SEQ_EMPTY);
+	}
+	history->size = 0;
+	history->head = 0;
+	history->seq = SEQ_EMPTY;
+}
+
+inline temp_t Storage::h_eReadTemp(uint16_t eIdx) {
+	return (temp_t) (ee_read(eIdx) | (ee_read(eIdx + 1) << 8));
+}
 
-	// shift days by one, so that position 0 is free
-	dh_dShift();
+inline void Storage::h_eStoreTemp(temp_t temp, uint16_t eIdx) {
+	ee_write(eIdx, temp & 0xFF);
+	ee_write(eIdx + 1, (temp >> 8) & 0xFF);
+}
 
-	// increase days after shift, so that we do not shift empty day.
-	EEPROM.write(EIDX_DAYS, ++dh_days);
+inline uint16_t Storage::h_eRead(Temp* temp, uint16_t eIdx) {
+	temp->avg = h_eReadTemp(eIdx);
+	temp->min = h_eReadTemp(eIdx + 2);
+	temp->max = h_eReadTemp(eIdx + 4);
+	return eIdx + TEMP_SIZE;
+}
 
-	// store current day on 0
-	uint8_t eIdx = dh_eIdx(0);
-	dh_eStore(temp, eIdx);
+inline uint16_t Storage::h_eStore(Temp* temp, uint16_t eIdx) {
+	h_eStoreTemp(temp->avg, eIdx);
+	h_eStoreTemp(temp->min, eIdx + 2);
+	h_eStoreTemp(temp->max, eIdx + 4);
+	return eIdx + TEMP_SIZE;
 }
 
-uint8_t Storage::dh_readDays() {
-	uint8_t size = EEPROM.read(EIDX_DAYS);
+/*
+ * Slot of the oldest entry gets marked as empty before it's overwritten, so that after power loss during write it's
+ * gone, instead of being read with broken content. Each step is flushed before the next one, sequence number goes
+ * with the next flush - it commits the entry.
+ */
+void Storage::h_store(History* history, Temp* temp) {
+	uint16_t slot = history->seq == SEQ_EMPTY ? 0 : (history->head + 1) % history->capacity;
+	uint16_t seq = h_nextSeq(history->seq);
 
 #if LOG
-	log(F("ST DS %u"), size);
+	log(F("ST W(%d,%d) %d,%d,%d"), slot, seq, temp->min, temp->max, temp->avg);
 #endif
-	return size;
+
+	h_storeSeq(history, slot, SEQ_EMPTY);
+	ee_flush();
+	uint16_t eIdx = h_eStore(temp, h_slotEIdx(history, slot) + 2);
+	ee_write(eIdx, h_crc(seq, temp));
+	ee_flush();
+	h_storeSeq(history, slot, seq);
+	if (rc_contains(history, slot)) {
+		cache.temps[slot - cache.firstSlot] = *temp;
+	}
+
+	history->head = slot;
+	history->seq = seq;
+	if (history->size < history->capacity) {
+		history->size++;
+	}
 }
 
-void Storage::dh_read(Temp* temp, uint8_t dIdx) {
-	uint8_t eIdx = dh_eIdx(dIdx);
-	temp->avg = EEPROM.read(eIdx++);
-	temp->min = EEPROM.read(eIdx++);
-	temp->max = EEPROM.read(eIdx);
+void Storage::h_read(History* history, Temp* temp, uint16_t hIdx) {
+	uint16_t slot = h_slot(history, hIdx);
+	if (!rc_contains(history, slot)) {
+		rc_load(history, slot);
+	}
+	Temp* cached = &cache.temps[slot - cache.firstSlot];
+	temp->avg = cached->avg;
+	temp->min = cached->min;
+	temp->max = cached->max;
 
 #if LOG
-	log(F("ST RD %u,%u->%d,%d,%d"), dIdx, eIdx, temp->min, temp->max, temp->avg);
+	log(F("ST RD %u,%u->%d,%d,%d"), hIdx, slot, temp->min, temp->max, temp->avg);
 #endif
 }
 
+inline boolean Storage::rc_contains(History* history, uint16_t slot) {
+	return cache.history == history && slot >= cache.firstSlot && slot < cache.firstSlot + ST_READ_CACHE_SIZE;
+}
+
+/*
+ * Loads block of slots ahead of given one in the direction of paging, older entries are in lower slots. The block
+ * keeps the slot read before, so that going one entry back and forth does not load it again. Empty slots are loaded
+ * too, they are never read.
+ */
+void Storage::rc_load(History* history, uint16_t slot) {
+	boolean up = cache.history == history && slot >= cache.firstSlot + ST_READ_CACHE_SIZE;
+	int32_t first = up ? (int32_t) slot - 1 : (int32_t) slot + 2 - ST_READ_CACHE_SIZE;
+	first = max(min(first, (int32_t) history->capacity - ST_READ_CACHE_SIZE), (int32_t) 0);
+
+	// slot read before is already decoded
+	uint16_t keptSlot = up ? slot - 1 : slot + 1;
+	Temp kept;
+	boolean keep = rc_contains(history, keptSlot);
+	if (keep) {
+		kept = cache.temps[keptSlot - cache.firstSlot];
+	}
+
+	cache.history = history;
+	cache.firstSlot = first;
+	for (uint8_t cIdx = 0; cIdx < ST_READ_CACHE_SIZE && cache.firstSlot + cIdx < history->capacity; cIdx++) {
+		if (keep && cache.firstSlot + cIdx == keptSlot) {
+			cache.temps[cIdx] = kept;
+		} else {
+			h_eRead(&cache.temps[cIdx], h_slotEIdx(history, cache.firstSlot + cIdx) + 2);
+		}
+	}
+}
+
+void Storage::dh_store(Temp* temp) {
+	h_store(&days, temp);
+}
+
+uint16_t Storage::dh_readDays() {
+	return days.size;
+}
+
+void Storage::dh_read(Temp* temp, uint16_t dIdx) {
+	h_read(&days, temp, dIdx);
+}
+
+void Storage::wh_store(Temp* temp) {
+	h_store(&weeks, temp);
+}
+
+uint16_t Storage::wh_readWeeks() {
+	return weeks.size;
+}
+
+void Storage::wh_read(Temp* temp, uint16_t wIdx) {
+	h_read(&weeks, temp, wIdx);
+}
+
+inline uint16_t Storage::cp_eIdx(uint8_t slot) {
+	return EIDX_CP_START + slot * CP_SIZE;
+}
+
+inline uint16_t Storage::cp_readSeq(uint8_t slot) {
+	uint16_t eIdx = cp_eIdx(slot);
+	return ee_read(eIdx) | (ee_read(eIdx + 1) << 8);
+}
+
+inline uint8_t Storage::cp_crc(uint16_t seq, uint8_t* data) {
+	uint8_t crc = util_crc8(0, seq & 0xFF);
+	crc = util_crc8(crc, seq >> 8);
+	for (uint8_t bIdx = 0; bIdx < 2 * TIER_CP_SIZE; bIdx++) {
+		crc = util_crc8(crc, data[bIdx]);
+	}
+	return crc;
+}
+
+/* Fields go one by one, little endian, so that the layout does not depend on padding of the compiler. */
+uint8_t* Storage::cp_packTier(TierCheckpoint* tier, uint8_t* data) {
+	for (uint8_t bIdx = 0; bIdx < 4; bIdx++) {
+		data[bIdx] = (tier->sum >> (bIdx * 8)) & 0xFF;
+		data[10 + bIdx] = (tier->elapsedMs >> (bIdx * 8)) & 0xFF;
+	}
+	data[4] = tier->count & 0xFF;
+	data[5] = tier->count >> 8;
+	data[6] = tier->min & 0xFF;
+	data[7] = (tier->min >> 8) & 0xFF;
+	data[8] = tier->max & 0xFF;
+	data[9] = (tier->max >> 8) & 0xFF;
+	return data + TIER_CP_SIZE;
+}
+
+uint8_t* Storage::cp_unpackTier(TierCheckpoint* tier, uint8_t* data) {
+	tier->sum = 0;
+	tier->elapsedMs = 0;
+	for (uint8_t bIdx = 0; bIdx < 4; bIdx++) {
+		tier->sum |= (uint32_t) data[bIdx] << (bIdx * 8);
+		tier->elapsedMs |= (uint32_t) data[10 + bIdx] << (bIdx * 8);
+	}
+	tier->count = data[4] | (data[5] << 8);
+	tier->min = (temp_t) (data[6] | (data[7] << 8));
+	tier->max = (temp_t) (data[8] | (data[9] << 8));
+	return data + TIER_CP_SIZE;
+}
+
+/* Reads checkpoint from given slot, false if it has been only partially written, when power went down during write. */
+boolean Storage::cp_read(uint8_t slot, uint16_t seq, StatsCheckpoint* checkpoint) {
+	uint16_t eIdx = cp_eIdx(slot) + 2;
+	uint8_t data[2 * TIER_CP_SIZE];
+	for (uint8_t bIdx = 0; bIdx < sizeof(data); bIdx++) {
+		data[bIdx] = ee_read(eIdx + bIdx);
+	}
+	if (ee_read(eIdx + sizeof(data)) != cp_crc(seq, data)) {
+		return false;
+	}
+	cp_unpackTier(&checkpoint->week, cp_unpackTier(&checkpoint->day, data));
+	return true;
+}
+
+void Storage::cp_store(StatsCheckpoint* checkpoint) {
+	// sequence 0 marks empty slot
+	if (++cpSeq == 0) {
+		cpSeq = 1;
+	}
+	uint16_t eIdx = cp_eIdx(cpSeq % ST_CHECKPOINT_SLOTS);
+	uint8_t data[2 * TIER_CP_SIZE];
+	cp_packTier(&checkpoint->week, cp_packTier(&checkpoint->day, data));
+
+	// sequence goes last, so that the slot becomes the most recent only when it's complete
+	for (uint8_t bIdx = 0; bIdx < sizeof(data); bIdx++) {
+		ee_write(eIdx + 2 + bIdx, data[bIdx]);
+	}
+	ee_write(eIdx + 2 + sizeof(data), cp_crc(cpSeq, data));
+	ee_flush();
+	ee_write(eIdx, cpSeq & 0xFF);
+	ee_write(eIdx + 1, cpSeq >> 8);
+}
+
+/* The most recent valid slot has been found on boot. */
+boolean Storage::cp_load(StatsCheckpoint* checkpoint) {
+	if (cpSeq == 0) {
+		return false;
+	}
+#if LOG
+	log(F("ST CP %u"), cpSeq);
+#endif
+	return cp_read(cpSeq % ST_CHECKPOINT_SLOTS, cpSeq, checkpoint);
+}
+
 void Storage::dh_clear() {
 #if LOG
 	log(F("ST CLR"));
 #endif
-	dh_days = 0;
-	EEPROM.write(EIDX_INIT_BYTE, INIT_BYTE);
-	EEPROM.write(EIDX_DAYS, 0);
-}
+	h_clear(&days);
+	h_clear(&weeks);
+	cache.history = NULL;
+	cpSeq = 0;
+	for (uint8_t slot = 0; slot < ST_CHECKPOINT_SLOTS; slot++) {
+		ee_write(cp_eIdx(slot), 0);
+		ee_write(cp_eIdx(slot) + 1, 0);
+	}
 
+	// storage is initialized only when it's empty
+	ee_flush();
+	sc_store();
+}
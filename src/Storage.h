@@ -19,63 +19,170 @@
 
 #include "Arduino.h"
 #include "StatsData.h"
-#include "EEPROM.h"
+#include "EepromWriter.h"
 #include "ArdLog.h"
 #include "Config.h"
+#include "Util.h"
 
 /**
- * Days in the history are being stored as FIFO, starting form 0 up to ST_DAY_HISTORY_SIZE.
+ * Days and weeks are kept in EEPROM as circular logs of #DAY_CAPACITY and #ST_WEEK_HISTORY_SIZE slots. New entry is
+ * written into the slot after the most recent one, together with its sequence number, storing into full history
+ * overwrites the oldest entry. Entries already stored never move: storing writes one slot only and each slot is written
+ * once per round. There is no head pointer in EEPROM, the most recent entry is found by sequence numbers after reboot.
+ * Days take whatever is left in EEPROM after weeks and checkpoints, up to #ST_DAY_HISTORY_MAX: 47 days on 1 KB of Uno,
+ * a year on 4 KB of Mega.
  *
+ * EEPROM starts with schema header: version and sizes of the layout, protected by CRC8. EEPROM with different header
+ * gets cleared on boot. Each entry and checkpoint has its own CRC8 over the sequence number and data, and is written
+ * in two phases: first data, then the sequence number - entry torn by power loss fails CRC and counts as empty.
  */
 class Storage {
 public:
+	// ################ EEPROM layout ################
+	// EIDX_XX - schema header at the beginning of the EEPROM: magic byte, version, amount of days (2 bytes) and weeks,
+	// checkpoint slots and size, CRC8
+	const static uint8_t EIDX_SCHEMA = 0;
+	const static uint8_t EIDX_SCHEMA_VERSION = 1;
+
+	/* amount of static data written at the beginning of EEPROM */
+	const static uint8_t EIDX_SIZE = 8;
+
+	/** Amount of bytes taken by one temperature (Temp) entry: avg, min, max - 2 bytes each. */
+	const static uint8_t TEMP_SIZE = 6;
+
+	/** Slot of the history: sequence number (2 bytes, 0 - empty slot), Temp and CRC8. */
+	const static uint8_t SLOT_SIZE = 2 + TEMP_SIZE + 1;
+	const static uint16_t SEQ_EMPTY = 0;
+
+	/** TierCheckpoint field by field: sum (4 bytes), count, min, max (2 bytes each), elapsedMs (4 bytes). */
+	const static uint8_t TIER_CP_SIZE = 14;
+
+	/** Checkpoint slot: sequence number (2 bytes, 0 - empty slot), day and week TierCheckpoint, CRC8. */
+	const static uint8_t CP_SIZE = 2 + 2 * TIER_CP_SIZE + 1;
+	static_assert(CP_SIZE == 31, "Checkpoint slot layout has changed, bump SCHEMA_VERSION");
+
+	const static uint16_t EIDX_WEEKS_START = EIDX_SIZE;
+	const static uint16_t EIDX_CP_START = EIDX_WEEKS_START + SLOT_SIZE * ST_WEEK_HISTORY_SIZE;
+	const static uint16_t EIDX_DAYS_START = EIDX_CP_START + CP_SIZE * ST_CHECKPOINT_SLOTS;
+	static_assert(EIDX_DAYS_START + SLOT_SIZE * 7 <= E2END + 1, "Week history does not fit into EEPROM");
+
+	/** Amount of days that fit into EEPROM of the board. */
+	const static uint16_t DAY_CAPACITY =
+			(E2END + 1 - EIDX_DAYS_START) / SLOT_SIZE < ST_DAY_HISTORY_MAX ?
+					(E2END + 1 - EIDX_DAYS_START) / SLOT_SIZE : ST_DAY_HISTORY_MAX;
+
 	Storage();
 	virtual ~Storage();
 
-	// idx starts from 0
+	// idx starts from 0, the most recent entry
 
-	// FIFO queue: stores given temp at 0, and shifts already stored data to the right.
+	// Stores given temp as the most recent entry at #dIdx 0, older entries get their index increased by one - only the
+	// index, nothing moves in EEPROM.
 	void dh_store(Temp* temp);
 
-	uint8_t dh_readDays();
+	uint16_t dh_readDays();
+
+	/* Most recent day is on #dIdx = 0, yesterday on #dIdx = 1, oldest day is at #dIdx = dh_readDays() - 1 */
+	void dh_read(Temp* dayTemp, uint16_t dIdx);
+
+	/* The same as dh_xxx, but for weeks. */
+	void wh_store(Temp* temp);
+	uint16_t wh_readWeeks();
+	void wh_read(Temp* weekTemp, uint16_t wIdx);
+
+	/* Stores checkpoint in the next slot, only changed bytes are written. */
+	void cp_store(StatsCheckpoint* checkpoint);
 
-	/* Most recent day is on #dIdx = 0, yesterday on #dIdx = 1, oldest day is at #dIdx = # dh_readDays() */
-	void dh_read(Temp* dayTemp, uint8_t dIdx);
+	/* Loads the most recent valid checkpoint, false if there is none. */
+	boolean cp_load(StatsCheckpoint* checkpoint);
 
+	/* Clears days, weeks and checkpoints. */
 	void dh_clear();
 
 private:
 
 	// eIdx - index in EEPROM, starting from 0, each byte is given by this position.
-	// dIdx - day index in history, starting from 0 until ST_DAY_HISTORY_SIZE
+	// hIdx - entry index in history, starting from 0 (most recent) until its size
+	// slot - position of the entry in the circular log
 
-	/* amount of days in history, max: dh_size = EIDX_DAYS */
-	uint8_t dh_days;
-
-	// EIDX_XX - static data at the beginning of the EEPROM
-	const static uint8_t EIDX_INIT_BYTE = 0;
-	const static uint8_t EIDX_DAYS = 1;
-
-	/* amount of static data written at the beginning of EEPROM */
-	const static uint8_t EIDX_SIZE = 2;
+	/* Single circular log in EEPROM. */
+	typedef struct {
+		/* EEPROM index of the slot 0. */
+		uint16_t eIdxStart;
+		uint16_t capacity;
 
-	/** Amount of bytes taken by one temperature (Temp) entry */
-	const static uint8_t TEMP_SIZE = 3;
-	const static uint8_t STORAGE_BYTES = EIDX_SIZE + TEMP_SIZE * ST_DAY_HISTORY_SIZE;
+		/* amount of entries in history, max: #capacity */
+		uint16_t size;
 
-	/* first byte of EEPROM indicating that it has been already initialised */
-	const static uint8_t INIT_BYTE = 105;
+		/* slot and sequence number of the most recent entry. */
+		uint16_t head;
+		uint16_t seq;
+	} History;
 
-	/* starting index of EEPROM for given day, counting from 0. */
-	inline uint8_t dh_eIdx(uint8_t dIdx);
-	inline uint8_t dh_eRead(Temp* temp, uint8_t eIdx);
-	inline uint8_t dh_eStore(Temp* temp, uint8_t eIdx);
+	History days;
+	History weeks;
 
 	/*
-	 * shift day stats in EEPROM to the right, so that last day get's removed and most recent day is
-	 * being moved from idx 0 to idx 1
+	 * Decoded entries of #ST_READ_CACHE_SIZE consecutive slots of one history, starting at #firstSlot. Paging through
+	 * the history reads EEPROM once per block. Stored entry goes into cache too.
 	 */
-	inline void dh_dShift();
+	typedef struct {
+		/* NULL - cache is empty */
+		History* history;
+		uint16_t firstSlot;
+		Temp temps[ST_READ_CACHE_SIZE];
+	} ReadCache;
+
+	ReadCache cache;
+
+	/* Sequence number of the last stored checkpoint. */
+	uint16_t cpSeq;
+
+	/* first byte of EEPROM indicating that it has been already initialised. */
+	const static uint8_t SCHEMA_MAGIC = 0x54;
+
+	/* changes with layout of the data, sizes are in the header anyway. */
+	const static uint8_t SCHEMA_VERSION = 1;
+
+	/* Header of the current layout, returns its CRC. */
+	uint8_t sc_header(uint8_t* header);
+	boolean sc_valid();
+	void sc_store();
+
+	/* slot of given entry, counting from 0 - the most recent one. */
+	inline uint16_t h_slot(History* history, uint16_t hIdx);
+	inline uint16_t h_slotEIdx(History* history, uint16_t slot);
+	inline uint16_t h_readSeq(History* history, uint16_t slot);
+	inline void h_storeSeq(History* history, uint16_t slot, uint16_t seq);
+
+	/* CRC8 of sequence number and entry, as stored in slot. */
+	static inline uint8_t h_crc(uint16_t seq, Temp* temp);
+	boolean h_valid(History* history, uint16_t slot);
+
+	/* Sequence numbers skip #SEQ_EMPTY. */
+	static inline uint16_t h_nextSeq(uint16_t seq);
+	static inline uint16_t h_prevSeq(uint16_t seq);
+
+	/* Finds the most recent entry and amount of entries from sequence numbers. */
+	void h_load(History* history);
+	void h_clear(History* history);
+	inline uint16_t h_eRead(Temp* temp, uint16_t eIdx);
+	inline uint16_t h_eStore(Temp* temp, uint16_t eIdx);
+	inline temp_t h_eReadTemp(uint16_t eIdx);
+	inline void h_eStoreTemp(temp_t temp, uint16_t eIdx);
+
+	void h_store(History* history, Temp* temp);
+	void h_read(History* history, Temp* temp, uint16_t hIdx);
+
+	inline boolean rc_contains(History* history, uint16_t slot);
+	void rc_load(History* history, uint16_t slot);
+
+	inline uint16_t cp_eIdx(uint8_t slot);
+	inline uint16_t cp_readSeq(uint8_t slot);
+	inline uint8_t cp_crc(uint16_t seq, uint8_t* data);
+	static uint8_t* cp_packTier(TierCheckpoint* tier, uint8_t* data);
+	static uint8_t* cp_unpackTier(TierCheckpoint* tier, uint8_t* data);
+	boolean cp_read(uint8_t slot, uint16_t seq, StatsCheckpoint* checkpoint);
 
 };
 
@@ -17,7 +17,8 @@
 #include "SystemStatus.h"
 
 SystemStatus::SystemStatus() :
-		state(0), switchMs(0), lastPinVal(LOW), sosEnabled(false) {
+		BusListener(ListenerSlot::STATUS, eb_mask(BusEvent::SERVICE_SUSPEND) | eb_mask(BusEvent::SERVICE_RESUME)), Task(
+				ListenerSlot::STATUS), state(0), sosEnabled(false) {
 	pinMode(DIG_PIN_SYSTEM_STATUS_LED, OUTPUT);
 	sosOn();
 }
@@ -25,53 +26,31 @@ SystemStatus::SystemStatus() :
 SystemStatus::~SystemStatus() {
 }
 
-void SystemStatus::onEvent(BusEvent event, va_list ap) {
-	if (event == BusEvent::CYCLE) {
-		cycle();
-	} else if (event == BusEvent::SERVICE_SUSPEND) {
+void SystemStatus::onEvent(const BusMsg* msg) {
+	if (msg->event == BusEvent::SERVICE_SUSPEND) {
 		sosOff();
-	} else if (event == BusEvent::SERVICE_RESUME) {
+	} else if (msg->event == BusEvent::SERVICE_RESUME) {
 		sosOn();
 	}
 }
 
 void SystemStatus::sosOn() {
-	sosEnabled = true;
+	if (!sosEnabled) {
+		sosEnabled = true;
+		state = 0;
+		sc_schedule(this, 0);
+	}
 }
 
 void SystemStatus::sosOff() {
 	if (sosEnabled) {
-		state = 1;
 		digitalWrite(DIG_PIN_SYSTEM_STATUS_LED, LOW);
-		switchMs = util_ms();
 		sosEnabled = false;
+		sc_cancel(this);
 	}
 }
 
-uint8_t SystemStatus::listenerId() {
-	return LISTENER_ID_STATUS;
-}
-void SystemStatus::doSwitch(uint16_t duration) {
-	uint32_t ms = millis();
-	if (ms - switchMs >= duration) {
-		state++;
-		switchMs = ms;
-	}
-}
 // States:
-// 1 - LED ON for long time
-// 2 - LED OFF
-// 3 - LED ON for long time
-// 4 - LED OFF
-// 5 - LED ON for long time
-// 6 - LED OFF
-// 7 - LED ON for short time
-// 8 - LED OFF
-// 9 - LED ON for short time
-// 10 - LED OFF
-// 11 - LED ON for short time
-// 12 - LED OFF
-
 //   1 - '.' -> LED ON for SOS_ON_SHORT_DURATION
 //   2 - ' ' -> LED OFF for SOS_OFF_DURATION
 //   3 - '.' -> LED ON for SOS_ON_SHORT_DURATION
@@ -94,12 +73,16 @@ void SystemStatus::doSwitch(uint16_t duration) {
 //  18 - ' ' -> LED OFF for SOS_OFF_DURATION
 //
 //  19 - ' ' -> LED OFF for SOS_PAUSE_DONE
-inline void SystemStatus::cycle() {
+//
+// Each run switches to the next state and returns its duration.
+uint32_t SystemStatus::run() {
 	if (!sosEnabled) {
-		return;
+		return SC_NEVER;
 	}
-	uint8_t pinVal = HIGH;
+	state = state == STATE_LAST ? 1 : state + 1;
 
+	uint8_t pinVal;
+	uint16_t duration;
 	switch (state) {
 
 	// '.' -> LED ON for SOS_ON_SHORT_DURATION
@@ -109,7 +92,7 @@ inline void SystemStatus::cycle() {
 	case 13:
 	case 15:
 	case 17:
-		doSwitch(SOS_ON_SHORT_DURATION);
+		duration = SOS_ON_SHORT_DURATION;
 		pinVal = HIGH;
 		break;
 
@@ -117,39 +100,22 @@ inline void SystemStatus::cycle() {
 	case 7:
 	case 9:
 	case 11:
-		doSwitch(SOS_ON_LONG_DURATION);
+		duration = SOS_ON_LONG_DURATION;
 		pinVal = HIGH;
 		break;
 
-	// ' ' -> LED OFF for SOS_OFF_DURATION
-	case 2:
-	case 4:
-	case 6:
-	case 8:
-	case 10:
-	case 12:
-	case 14:
-	case 16:
-	case 18:
-		doSwitch(SOS_OFF_DURATION);
-		pinVal = LOW;
-		break;
-
-	case 19:
-		doSwitch(SOS_PAUSE_DONE);
+	case STATE_LAST:
+		duration = SOS_PAUSE_DONE;
 		pinVal = LOW;
 		break;
 
+	// ' ' -> LED OFF for SOS_OFF_DURATION
 	default:
-		state = 1;
+		duration = SOS_OFF_DURATION;
+		pinVal = LOW;
 		break;
 	}
 
-	if (lastPinVal != pinVal) {
-		digitalWrite(DIG_PIN_SYSTEM_STATUS_LED, pinVal);
-	}
-	lastPinVal = pinVal;
-
+	digitalWrite(DIG_PIN_SYSTEM_STATUS_LED, pinVal);
+	return duration;
 }
-
-
@@ -20,8 +20,10 @@
 #include "EventBus.h"
 #include "Config.h"
 #include "Util.h"
+#include "Scheduler.h"
 
-class SystemStatus: public BusListener {
+/** Blinks SOS on status LED. Each LED switch is a scheduled task, so nothing runs between switches. */
+class SystemStatus: public BusListener, public Task {
 public:
 	SystemStatus();
 	virtual ~SystemStatus();
@@ -39,17 +41,16 @@ private:
 	/** Pause time after single SOS message (3x long, 3x short). */
 	static const uint16_t SOS_PAUSE_DONE = 3000;
 
+	/* Last state of the SOS sequence, 1 - 19. */
+	const static uint8_t STATE_LAST = 19;
+
 	uint8_t state;
-	uint32_t switchMs;
-	uint8_t lastPinVal;
 	boolean sosEnabled;
 
-	void onEvent(BusEvent event, va_list ap);
-	uint8_t listenerId();
+	void onEvent(const BusMsg* msg);
 	void sosOn();
 	void sosOff();
-	void doSwitch(uint16_t duration);
-	inline void cycle();
+	uint32_t run();
 };
 
 #endif /* SYSTEMSTATUS_H_ */
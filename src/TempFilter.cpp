@@ -0,0 +1,97 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "TempFilter.h"
+#include "Util.h"
+
+/* Rounds x / 2^shift half away from zero. */
+static inline temp_t unscale(int32_t x, uint8_t shift) {
+	int32_t half = (int32_t) 1 << (shift - 1);
+	return x >= 0 ? (x + half) >> shift : -((-x + half) >> shift);
+}
+
+TempFilter::TempFilter(FilterStage input) :
+		input(input) {
+}
+
+TempFilter::~TempFilter() {
+}
+
+// ############### SpikeFilter ###############
+SpikeFilter::SpikeFilter(FilterStage input) :
+		TempFilter(input), last(0), rejected(0), empty(true) {
+}
+
+void SpikeFilter::clear() {
+	empty = true;
+	rejected = 0;
+}
+
+temp_t SpikeFilter::add(temp_t sample) {
+	if (!empty && util_abs16(sample - last) > TF_SPIKE_MAX && ++rejected < TF_SPIKE_HOLD) {
+		return last;
+	}
+	empty = false;
+	rejected = 0;
+	last = sample;
+	return last;
+}
+
+// ############### EmaFilter ###############
+EmaFilter::EmaFilter(FilterStage input) :
+		TempFilter(input), sum(0), empty(true) {
+}
+
+void EmaFilter::clear() {
+	empty = true;
+}
+
+temp_t EmaFilter::add(temp_t sample) {
+	if (empty) {
+		sum = (int32_t) sample << TF_EMA_SHIFT;
+		empty = false;
+	} else {
+		sum += sample - unscale(sum, TF_EMA_SHIFT);
+	}
+	return unscale(sum, TF_EMA_SHIFT);
+}
+
+// ############### KalmanFilter ###############
+KalmanFilter::KalmanFilter(FilterStage input) :
+		TempFilter(input), estimate(0), variance(0), empty(true) {
+}
+
+void KalmanFilter::clear() {
+	empty = true;
+}
+
+temp_t KalmanFilter::add(temp_t sample) {
+	int32_t measured = (int32_t) sample << FRAC;
+	if (empty) {
+		estimate = measured;
+		variance = TF_KALMAN_R;
+		empty = false;
+	} else {
+		// predict: temperature stays, uncertainty grows
+		variance += TF_KALMAN_Q;
+
+		// update: gain in 1/2^FRAC
+		int32_t gain = (variance << FRAC) / (variance + TF_KALMAN_R);
+		estimate += (measured - estimate) * gain >> FRAC;
+		variance -= variance * gain >> FRAC;
+	}
+	return unscale(estimate, FRAC);
+}
@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEMPFILTER_H_
+#define TEMPFILTER_H_
+
+#include "Arduino.h"
+#include "Config.h"
+#include "Temperature.h"
+
+/**
+ * Stage of the filter chain in TempSensor. Filter reads output of #input stage and its own output becomes the next
+ * stage. Filters keep their state in fixed size members, nothing is allocated.
+ */
+class TempFilter {
+public:
+	TempFilter(FilterStage input);
+	virtual ~TempFilter();
+
+	/** Adds sample and returns filtered temperature. */
+	virtual temp_t add(temp_t sample) = 0;
+
+	/** Forgets all samples, next one will be taken as it is. */
+	virtual void clear() = 0;
+
+	const FilterStage input;
+};
+
+/** Drops single probes far away from the last accepted one, like 85.0 after power-on reset or broken reads. */
+class SpikeFilter: public TempFilter {
+public:
+	SpikeFilter(FilterStage input);
+	temp_t add(temp_t sample);
+	void clear();
+
+private:
+	temp_t last;
+	uint8_t rejected;
+	boolean empty;
+};
+
+/** Exponential moving average with weight 1/2^#TF_EMA_SHIFT of the new sample. */
+class EmaFilter: public TempFilter {
+public:
+	EmaFilter(FilterStage input);
+	temp_t add(temp_t sample);
+	void clear();
+
+private:
+	/* Average multiplied by 2^#TF_EMA_SHIFT. */
+	int32_t sum;
+	boolean empty;
+};
+
+/** One dimensional Kalman filter assuming that temperature is constant apart from #TF_KALMAN_Q noise. */
+class KalmanFilter: public TempFilter {
+public:
+	KalmanFilter(FilterStage input);
+	temp_t add(temp_t sample);
+	void clear();
+
+private:
+	/* Estimate multiplied by 2^#FRAC. */
+	int32_t estimate;
+
+	/* Variance of the estimate, in the same unit as #TF_KALMAN_Q and #TF_KALMAN_R. */
+	int32_t variance;
+	boolean empty;
+
+	const static uint8_t FRAC = 8;
+};
+
+#endif /* TEMPFILTER_H_ */
@@ -0,0 +1,163 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "TempLog.h"
+
+/* Value bits for prefix with given amount of leading ones, prefix with 4 ones has no terminating zero. */
+const static uint8_t VALUE_BITS[] = { 0, 2, 4, 7, 16 };
+
+TempLog::TempLog() {
+	clear();
+}
+
+void TempLog::clear() {
+	head = 0;
+	used = 0;
+	last = 0;
+}
+
+uint16_t TempLog::size() {
+	uint16_t size = 0;
+	for (uint8_t age = 0; age < used; age++) {
+		size += blocks[blockIdx(age)].count;
+	}
+	return size;
+}
+
+uint16_t TempLog::bytes() {
+	uint16_t bytes = 0;
+	for (uint8_t age = 0; age < used; age++) {
+		bytes += sizeof(Block) + (blocks[blockIdx(age)].bits + 7) / 8;
+	}
+	return bytes;
+}
+
+inline uint8_t TempLog::blockIdx(uint8_t age) {
+	return (head + age) % TL_BLOCKS;
+}
+
+inline TempLog::Block* TempLog::newest() {
+	return &blocks[blockIdx(used - 1)];
+}
+
+inline uint8_t* TempLog::newestData() {
+	return data[blockIdx(used - 1)];
+}
+
+void TempLog::add(temp_t temp) {
+	int16_t delta = temp - last;
+	uint8_t ones = codeOnes(delta);
+	uint8_t prefixBits = ones == 4 ? 4 : ones + 1;
+	uint8_t valueBits = VALUE_BITS[ones];
+
+	if (used == 0 || newest()->count == 0xFF
+			|| newest()->bits + prefixBits + valueBits > (uint16_t) TL_BLOCK_BYTES * 8) {
+		// new block, the oldest one is dropped when all are used
+		if (used == TL_BLOCKS) {
+			head = (head + 1) % TL_BLOCKS;
+		} else {
+			used++;
+		}
+		Block* block = newest();
+		block->first = temp;
+		block->count = 1;
+		block->bits = 0;
+		last = temp;
+		return;
+	}
+
+	Block* block = newest();
+	uint8_t* buf = newestData();
+
+	// prefix: ones terminated by zero, apart from the longest one
+	writeBits(buf, block->bits, ones == 4 ? 0x0F : ((1 << ones) - 1) << 1, prefixBits);
+	writeBits(buf, block->bits + prefixBits, delta, valueBits);
+	block->bits += prefixBits + valueBits;
+	block->count++;
+	last = temp;
+}
+
+inline uint8_t TempLog::codeOnes(int16_t delta) {
+	if (delta == 0) {
+		return 0;
+	}
+	for (uint8_t ones = 1; ones < 4; ones++) {
+		int16_t range = 1 << (VALUE_BITS[ones] - 1);
+		if (delta >= -range && delta < range) {
+			return ones;
+		}
+	}
+	return 4;
+}
+
+inline void TempLog::writeBits(uint8_t* buf, uint16_t bitIdx, uint16_t value, uint8_t bits) {
+	for (int8_t bIdx = bits - 1; bIdx >= 0; bIdx--, bitIdx++) {
+		uint8_t mask = 0x80 >> (bitIdx & 7);
+		if ((value >> bIdx) & 1) {
+			buf[bitIdx >> 3] |= mask;
+		} else {
+			buf[bitIdx >> 3] &= ~mask;
+		}
+	}
+}
+
+inline uint16_t TempLog::readBits(uint8_t* buf, uint16_t bitIdx, uint8_t bits) {
+	uint16_t value = 0;
+	for (uint8_t bIdx = 0; bIdx < bits; bIdx++, bitIdx++) {
+		value = (value << 1) | ((buf[bitIdx >> 3] >> (7 - (bitIdx & 7))) & 1);
+	}
+	return value;
+}
+
+// ################################ Reader ################################
+TempLog::Reader::Reader(TempLog* log) :
+		log(log), block(0), sample(0), bitIdx(0), prev(0) {
+}
+
+boolean TempLog::Reader::hasNext() {
+	return block < log->used && sample < log->blocks[log->blockIdx(block)].count;
+}
+
+temp_t TempLog::Reader::next() {
+	uint8_t bIdx = log->blockIdx(block);
+	Block* blk = &log->blocks[bIdx];
+	if (sample == 0) {
+		prev = blk->first;
+		bitIdx = 0;
+	} else {
+		uint8_t* buf = log->data[bIdx];
+		uint8_t ones = 0;
+		while (ones < 4 && readBits(buf, bitIdx++, 1) == 1) {
+			ones++;
+		}
+		uint8_t valueBits = VALUE_BITS[ones];
+		int16_t delta = 0;
+		if (valueBits > 0) {
+			// sign extension
+			uint16_t raw = readBits(buf, bitIdx, valueBits);
+			delta = valueBits < 16 && (raw >> (valueBits - 1)) ? raw - (1 << valueBits) : (int16_t) raw;
+			bitIdx += valueBits;
+		}
+		prev += delta;
+	}
+
+	if (++sample == blk->count) {
+		block++;
+		sample = 0;
+	}
+	return prev;
+}
+// ##############################################################################
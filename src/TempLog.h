@@ -0,0 +1,89 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEMPLOG_H_
+#define TEMPLOG_H_
+
+#include "Arduino.h"
+#include "Config.h"
+#include "Temperature.h"
+
+/**
+ * Compressed FIFO of temperatures sampled at fixed interval - TempStats adds average of each minute.
+ *
+ * Samples are encoded as difference to the previous one with prefix code: '0' for no change, '10' + 2 bits, '110' +
+ * 4 bits, '1110' + 7 bits and '1111' + 16 bits. Minute averages change slowly, but have some noise, and noise makes
+ * delta-of-delta twice as large as delta: steady temperature takes 1 bit per sample, noisy one 3-4.
+ *
+ * Bit stream is split into #TL_BLOCKS blocks of #TL_BLOCK_BYTES, each one starting with its first sample as it is, so
+ * that the oldest block can be dropped to make space for new samples without decoding anything.
+ */
+class TempLog {
+public:
+	TempLog();
+	void add(temp_t temp);
+
+	/** Amount of samples that can be read. */
+	uint16_t size();
+
+	/** Bytes taken by samples: encoded bits and block headers. */
+	uint16_t bytes();
+	void clear();
+
+	/** Decodes samples from the oldest one, log cannot change during reading. */
+	class Reader {
+	public:
+		Reader(TempLog* log);
+		boolean hasNext();
+		temp_t next();
+	private:
+		TempLog* const log;
+
+		/* Block counted from the oldest one. */
+		uint8_t block;
+		uint8_t sample;
+		uint16_t bitIdx;
+		temp_t prev;
+	};
+
+private:
+	typedef struct {
+		temp_t first;
+		uint8_t count;
+		uint16_t bits;
+	} Block;
+
+	uint8_t data[TL_BLOCKS][TL_BLOCK_BYTES];
+	Block blocks[TL_BLOCKS];
+
+	/* Index of the oldest block and amount of used ones. */
+	uint8_t head;
+	uint8_t used;
+
+	/* Last sample, next one is encoded as difference to it. */
+	temp_t last;
+
+	inline Block* newest();
+	inline uint8_t* newestData();
+	inline uint8_t blockIdx(uint8_t age);
+
+	/* Amount of ones in the prefix of given delta, shortest code that can hold it. */
+	static inline uint8_t codeOnes(int16_t delta);
+	static inline void writeBits(uint8_t* buf, uint16_t bitIdx, uint16_t value, uint8_t bits);
+	static inline uint16_t readBits(uint8_t* buf, uint16_t bitIdx, uint8_t bits);
+};
+
+#endif /* TEMPLOG_H_ */
@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "TempRing.h"
+
+TempRing::TempRing(PackedTemp* buf, uint8_t capacity) :
+		buf(buf), capacity(capacity), head(0), amount(0) {
+}
+
+static uint8_t distance(temp_t from, temp_t to) {
+	int32_t dist = to >= from ? (int32_t) to - from : 0;
+	return dist > 0xFF ? 0xFF : dist;
+}
+
+void TempRing::store(Temp* temp) {
+	PackedTemp* packed = &buf[head];
+	packed->avg = temp->avg;
+	packed->belowAvg = distance(temp->min, temp->avg);
+	packed->aboveAvg = distance(temp->avg, temp->max);
+	head = (head + 1) % capacity;
+	if (amount < capacity) {
+		amount++;
+	}
+}
+
+uint8_t TempRing::size() {
+	return amount;
+}
+
+void TempRing::read(Temp* temp, uint8_t hIdx) {
+	PackedTemp* packed = &buf[(head + capacity - 1 - hIdx) % capacity];
+	temp->avg = packed->avg;
+	temp->min = packed->avg - packed->belowAvg;
+	temp->max = packed->avg + packed->aboveAvg;
+	temp->day = hIdx;
+}
+
+void TempRing::clear() {
+	head = 0;
+	amount = 0;
+}
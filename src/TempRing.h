@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEMPRING_H_
+#define TEMPRING_H_
+
+#include "Arduino.h"
+#include "StatsData.h"
+
+/**
+ * Temp as kept in RAM, 4 bytes instead of 8: average and distances of min and max from it. Distance saturates at 255,
+ * so min and max further than 25.5 degrees from the average of the entry get cut.
+ */
+typedef struct {
+	temp_t avg;
+	uint8_t belowAvg;
+	uint8_t aboveAvg;
+} PackedTemp;
+
+/** History of Temp in RAM: most recent entry on 0, full ring overwrites the oldest. */
+class TempRing {
+public:
+	/** #buf has to hold #capacity entries, it's owned by the caller. */
+	TempRing(PackedTemp* buf, uint8_t capacity);
+	void store(Temp* temp);
+	uint8_t size();
+
+	/** Most recent entry is on #hIdx = 0. */
+	void read(Temp* temp, uint8_t hIdx);
+	void clear();
+
+private:
+	PackedTemp* const buf;
+	const uint8_t capacity;
+
+	/* Position of the next entry to be stored. */
+	uint8_t head;
+	uint8_t amount;
+};
+
+#endif /* TEMPRING_H_ */
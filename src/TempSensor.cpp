@@ -15,43 +15,105 @@
  * limitations under the License.
  */
 #include "TempSensor.h"
+#include "Recorder.h"
 
 TempSensor::TempSensor() :
-		probeIdx(0), curentTemp(0), lastTemp(0), lastProbeTime(0), oneWire(DIG_PIN_TEMP_SENSOR), dallasTemperature(
-				&oneWire) {
+		Service(ListenerSlot::TEMP_SENSOR), spikeFilter(FilterStage::RAW), medianFilter(FilterStage::SPIKE), emaFilter(
+				FilterStage::MEDIAN), kalmanFilter(FilterStage::SPIKE), filters { &spikeFilter, &medianFilter,
+				&emaFilter, &kalmanFilter }, oneWire(DIG_PIN_TEMP_SENSOR), dallasTemperature(
+				&oneWire), sensorsAmount(0), probeMs(TS_PROBE_FREQ_MS), minProbeMs(TS_PROBE_FREQ_MS), conversionMs(0), probes(
+				0), stableProbes(0), lastEstimate(0), converting(false) {
 }
 
-int8_t TempSensor::getTemp() {
-	return curentTemp;
+temp_t TempSensor::getTemp() {
+	return stageTemps[(uint8_t) FilterStage::MEDIAN];
 }
 
-int8_t TempSensor::getQuickTemp() {
-	return lastTemp;
+temp_t TempSensor::getFilteredTemp(FilterStage stage) {
+	return stageTemps[(uint8_t) stage];
+}
+
+temp_t TempSensor::getQuickTemp() {
+	return temps[0];
+}
+
+uint8_t TempSensor::getSensorsAmount() {
+	return sensorsAmount;
+}
+
+temp_t TempSensor::getSensorTemp(uint8_t sensorIdx) {
+	return temps[sensorIdx];
+}
+
+uint32_t TempSensor::getProbeMs() {
+	return probeMs;
+}
+
+uint32_t TempSensor::getProbes() {
+	return probes;
 }
 
 void TempSensor::init() {
 	dallasTemperature.begin();
-	curentTemp = readTemp();
+	uint8_t found = dallasTemperature.getDeviceCount();
+	for (uint8_t sIdx = 0; sIdx < found && sensorsAmount < TS_SENSORS_MAX; sIdx++) {
+		if (dallasTemperature.getAddress(addresses[sensorsAmount], sIdx)) {
+			sensorsAmount++;
+		}
+	}
+#if LOG
+	log(F("TS %d/%d"), sensorsAmount, found);
+#endif
+
+	// first conversion blocks, so that temperature is known before other services start
+	dallasTemperature.requestTemperatures();
+	dallasTemperature.setWaitForConversion(false);
+	readSensors();
+	filter();
+	lastEstimate = stageTemps[(uint8_t) FilterStage::KALMAN];
+	conversionMs = dallasTemperature.millisToWaitForConversion(dallasTemperature.getResolution());
+	minProbeMs = max(TS_PROBE_FREQ_MS, conversionMs);
+	probeMs = minProbeMs;
 }
 
-void TempSensor::cycle() {
-	uint32_t ms = util_ms();
-	if (ms - lastProbeTime < TS_PROBE_FREQ_MS) {
-		return;
+/*
+ * Conversion runs between executions: one starts it and the next one reads the result. It would block loop() for up
+ * to 750ms otherwise. Conversion starts just before the probe is due, so that the result is fresh even with long
+ * #probeMs.
+ */
+uint32_t TempSensor::cycle() {
+	if (!converting) {
+		// single convert T for all sensors on the bus
+		dallasTemperature.requestTemperatures();
+		converting = true;
+		return conversionMs;
+	}
+	if (!dallasTemperature.isConversionComplete()) {
+		return TS_CONVERSION_RETRY_MS;
 	}
-	lastProbeTime = ms;
-	int8_t temp = readTemp();
-	lastTemp = temp;
-	if (probeIdx == TS_PROBES_SIZE) {
-		util_sort_i8(probes, TS_PROBES_SIZE);
-		curentTemp = probes[TS_PROBES_MED_IDX];
-		probeIdx = 0;
+	converting = false;
+	readSensors();
+	filter();
+	adaptProbeMs();
 #if TRACE
-		log(F("TS CY %d->%d %d %d"), curentTemp, probes[0], probes[1], probes[2]);
+	log(F("TS CY %d->%d %lu"), temps[0], getTemp(), probeMs);
 #endif
+	return probeMs - conversionMs;
+}
+
+inline void TempSensor::adaptProbeMs() {
+	temp_t estimate = stageTemps[(uint8_t) FilterStage::KALMAN];
+	temp_t derivative = estimate - lastEstimate;
+	temp_t noise = temps[0] - stageTemps[(uint8_t) FilterStage::MEDIAN];
+	lastEstimate = estimate;
 
-	} else {
-		probes[probeIdx++] = temp;
+	if (util_abs16(derivative) > TS_STABLE_DELTA || util_abs16(noise) > TS_STABLE_DELTA) {
+		stableProbes = 0;
+		probeMs = minProbeMs;
+
+	} else if (++stableProbes >= TS_STABLE_PROBES) {
+		stableProbes = 0;
+		probeMs = min(probeMs * 2, max(TS_PROBE_MAX_MS, minProbeMs));
 	}
 }
 
@@ -59,11 +121,32 @@ uint8_t TempSensor::deviceId() {
 	return DEVICE_ID_TEMP_SENSOR;
 }
 
-inline int8_t TempSensor::readTemp() {
-	dallasTemperature.requestTemperatures();
-	int8_t temp = (int8_t) (dallasTemperature.getTempCByIndex(0) + 0.5);
+inline void TempSensor::readSensors() {
+	for (uint8_t sIdx = 0; sIdx < sensorsAmount; sIdx++) {
+		temps[sIdx] = readTemp(sIdx);
+	}
+	if (sensorsAmount == 0) {
+		temps[0] = readTemp(0); // disconnected
+	}
+	probes++;
+#if ENABLE_RECORDER
+	rec_temp(temps[0]);
+#endif
+}
+
+inline void TempSensor::filter() {
+	stageTemps[(uint8_t) FilterStage::RAW] = temps[0];
+	for (uint8_t fIdx = 0; fIdx < (uint8_t) FilterStage::AMOUNT - 1; fIdx++) {
+		TempFilter* filter = filters[fIdx];
+		stageTemps[fIdx + 1] = filter->add(stageTemps[(uint8_t) filter->input]);
+	}
+}
+
+inline temp_t TempSensor::readTemp(uint8_t sensorIdx) {
+	int32_t raw = sensorIdx < sensorsAmount ? dallasTemperature.getTemp(addresses[sensorIdx]) : DEVICE_DISCONNECTED_RAW;
+	temp_t temp = temp_fromRaw(raw);
 #if USE_FEHRENHEIT
-	temp = temp * 1.8 + 32;
+	temp = temp_toFahrenheit(temp);
 #endif
 	return temp;
 }
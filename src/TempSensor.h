@@ -25,26 +25,77 @@
 #include "ArdLogSetup.h"
 #include "Service.h"
 #include "Config.h"
+#include "Temperature.h"
+#include "MedianFilter.h"
 
 class TempSensor: public Service {
 public:
 	TempSensor();
-	virtual int8_t getTemp();
-	virtual int8_t getQuickTemp();
+	/** Median of the recent probes from the first sensor. */
+	virtual temp_t getTemp();
+
+	/** Last probe from the first sensor. */
+	virtual temp_t getQuickTemp();
+
+	/** Output of given stage of the filter chain for the first sensor. */
+	virtual temp_t getFilteredTemp(FilterStage stage);
 	void init();
 
+	/** Amount of sensors found on the bus by #init(), up to #TS_SENSORS_MAX. */
+	uint8_t getSensorsAmount();
+
+	/** Last temperature read from given sensor, sensor 0 is the one returned by #getQuickTemp(). */
+	temp_t getSensorTemp(uint8_t sensorIdx);
+
+	/** Current time between probes, it changes with the rate of change of the temperature. */
+	uint32_t getProbeMs();
+
+	/** Amount of probes since start. */
+	uint32_t getProbes();
+
 private:
-	int8_t probes[TS_PROBES_SIZE] = {};
-	uint8_t probeIdx;
-	int8_t curentTemp;
-	int8_t lastTemp;
-	uint32_t lastProbeTime;
+	SpikeFilter spikeFilter;
+	MedianFilter medianFilter;
+	EmaFilter emaFilter;
+	KalmanFilter kalmanFilter;
+
+	/* Filter producing each stage apart from FilterStage::RAW, in order of stages. */
+	TempFilter* const filters[(uint8_t) FilterStage::AMOUNT - 1];
+	temp_t stageTemps[(uint8_t) FilterStage::AMOUNT] = {};
 	OneWire oneWire;
 	DallasTemperature dallasTemperature;
 
-	inline int8_t readTemp();
+	/* Addresses found by #init(), sensors are read by address - without searching the bus each time. */
+	DeviceAddress addresses[TS_SENSORS_MAX];
+	temp_t temps[TS_SENSORS_MAX] = {};
+	uint8_t sensorsAmount;
+
+	/* Time between probes, from #minProbeMs to #TS_PROBE_MAX_MS. */
+	uint32_t probeMs;
+
+	/* Shortest #probeMs, the conversion has to fit in it. */
+	uint32_t minProbeMs;
+	uint32_t conversionMs;
+	uint32_t probes;
+	uint8_t stableProbes;
+	temp_t lastEstimate;
+
+	/* True between start of the conversion and reading its result. */
+	boolean converting;
+
+	/* Reads temperature from finished conversion. */
+	inline temp_t readTemp(uint8_t sensorIdx);
+
+	/* Reads result of the conversion from all sensors. */
+	inline void readSensors();
+
+	/* Changes #probeMs based on the last probe. */
+	inline void adaptProbeMs();
+
+	/* Passes last probe of the first sensor through the filter chain. */
+	inline void filter();
 	uint8_t deviceId();
-	void cycle();
+	uint32_t cycle();
 };
 
 #endif /* TEMPSENSOR_H_ */
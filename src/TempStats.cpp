@@ -16,129 +16,270 @@
  */
 #include "TempStats.h"
 
+/* Length of the entry in each tier. */
+const static uint32_t TIER_MS[] = { ST_MINUTE_MS, ST_HOUR_MS, ST_DAY_MS, ST_WEEK_MS };
+
 TempStats::TempStats(TempSensor* tempSensor, Storage* storage) :
-		tempSensor(tempSensor), storage(storage), dit(this), dp( { { }, 0, 0 }), ap( { 0, { 99, 99, -99, 99 } }) {
+		Service(ListenerSlot::TEMP_STATS), BusListener(ListenerSlot::TEMP_STATS, eb_mask(BusEvent::CLEAR_STATS)), tempSensor(
+				tempSensor), storage(storage), iterators { { this, StatsTier::MINUTE }, { this, StatsTier::HOUR }, {
+				this, StatsTier::DAY }, { this, StatsTier::WEEK } }, tierProbes { }, ap( { 0, { temp_deg(99), temp_deg(
+				99), temp_deg(-99), 99 }, RollingMinMax() }), minutes(minuteBuf, ST_MINUTE_HISTORY_SIZE), hours(hourBuf,
+				ST_HOUR_HISTORY_SIZE) {
 }
 
 void TempStats::init() {
 	initTemp(&ap.temp);
+	clearTiers();
+	restore();
+}
+
+TempStats::TierIterator* TempStats::di() {
+	return ti(StatsTier::DAY);
 }
 
-TempStats::DayIteroator* TempStats::di() {
-	return &dit;
+TempStats::TierIterator* TempStats::ti(StatsTier tier) {
+	return &iterators[(uint8_t) tier];
 }
+
+#if ENABLE_TEMP_LOG
+TempLog* TempStats::minuteLog() {
+	return &mLog;
+}
+#endif
+
 void TempStats::clearStats() {
 	storage->dh_clear();
-	dit.reset();
 	initTemp(&ap.temp);
+	ap.rolling.clear();
+	clearTiers();
+}
+
+inline void TempStats::clearTiers() {
+	minutes.clear();
+	hours.clear();
+#if ENABLE_TEMP_LOG
+	mLog.clear();
+#endif
+	for (uint8_t tIdx = 0; tIdx < (uint8_t) StatsTier::AMOUNT; tIdx++) {
+		tierProbes[tIdx].count = 0;
+		iterators[tIdx].reset();
+	}
 }
 
 inline void TempStats::initTemp(Temp* temp) {
 	temp->day = 99;
-	temp->avg = 99;
-	temp->min = 99;
-	temp->max = -99;
+	temp->avg = temp_deg(99);
+	temp->min = temp_deg(99);
+	temp->max = temp_deg(-99);
 }
 
-void TempStats::onEvent(BusEvent event, va_list ap) {
-	if (event == BusEvent::CLEAR_STATS) {
+void TempStats::onEvent(const BusMsg* msg) {
+	if (msg->event == BusEvent::CLEAR_STATS) {
 		clearStats();
 	}
 }
 
-uint8_t TempStats::listenerId() {
-	return deviceId();
-}
-
 Temp* TempStats::actual() {
 	return &ap.temp;
 }
 
-void TempStats::cycle() {
-	probeActualTemp();
-	probeDayTemp();
+uint32_t TempStats::cycle() {
+	uint32_t ms = util_ms();
+	uint32_t elapsedMs = ms - ap.lastProbeMs;
+	if (elapsedMs < ST_ACTUAL_PROBE_MS) {
+		return ST_ACTUAL_PROBE_MS - elapsedMs;
+	}
+	ap.lastProbeMs = ms;
+
+	temp_t temp = tempSensor->getTemp();
+	probeActualTemp(ms, temp);
+	probeTier(StatsTier::MINUTE, ms, temp, temp, temp);
+	return ST_ACTUAL_PROBE_MS;
 }
 
 uint8_t TempStats::deviceId() {
 	return DEVICE_ID_STATS;
 }
 
-void TempStats::probeActualTemp() {
-	uint32_t ms = util_ms();
-	if (ms - ap.lastProbeMs < ST_ACTUAL_PROBE_MS) {
-		return;
-	}
-	ap.lastProbeMs = ms;
-
-	int8_t actTemp = tempSensor->getTemp();
-	ap.temp.min = min(ap.temp.min, actTemp);
-	ap.temp.max = max(ap.temp.max, actTemp);
+inline void TempStats::probeActualTemp(uint32_t ms, temp_t temp) {
+	ap.rolling.add(ms, temp);
+	ap.temp.min = ap.rolling.getMin();
+	ap.temp.max = ap.rolling.getMax();
 
 #if TRACE
-	log(F("TES ACT:%d,%d,%d"), actTemp, ap.temp.min, ap.temp.max);
+	log(F("TES ACT:%d,%d,%d"), temp, ap.temp.min, ap.temp.max);
 #endif
 }
 
-void TempStats::probeDayTemp() {
+/*
+ * Probes come in fixed intervals, so the average is weighted by time - also when TempSensor adapts its own probe
+ * period. Entry starts with its first probe and gets stored with the first probe that does not fit into it anymore.
+ * Coarser tiers average entries of the finer one, min and max are carried over.
+ */
+void TempStats::probeTier(StatsTier tier, uint32_t startMs, temp_t avg, temp_t tMin, temp_t tMax) {
+	uint8_t tIdx = (uint8_t) tier;
+	TierProbe* tp = &tierProbes[tIdx];
+	if (tp->count > 0 && startMs - tp->startMs >= TIER_MS[tIdx]) {
+		Temp closed = { 0, tp->min, tp->max, 0 };
+		int32_t half = tp->sum >= 0 ? tp->count / 2 : -(int32_t) (tp->count / 2);
+		closed.avg = (tp->sum + half) / (int32_t) tp->count;
+		uint32_t closedMs = tp->startMs;
+		tp->count = 0;
+
+		storeTier(tier, &closed);
+		if (tIdx + 1 < (uint8_t) StatsTier::AMOUNT) {
+			probeTier((StatsTier) (tIdx + 1), closedMs, closed.avg, closed.min, closed.max);
+		}
+	}
+	if (tp->count == 0) {
+		tp->startMs = startMs;
+		tp->sum = 0;
+		tp->min = tMin;
+		tp->max = tMax;
+	}
+	tp->sum += avg;
+	tp->count++;
+	tp->min = min(tp->min, tMin);
+	tp->max = max(tp->max, tMax);
+
+	// once an hour
+	if (tier == StatsTier::DAY) {
+		checkpoint();
+	}
+}
+
+/*
+ * Time when board was off is not known, so after reboot day and week continue from where they were stopped. Current
+ * hour is lost.
+ */
+void TempStats::checkpoint() {
 	uint32_t ms = util_ms();
-	if (ms - dp.lastProbeMs < ST_DAY_PROBE_MS) {
+	StatsCheckpoint cp;
+	toCheckpoint(StatsTier::DAY, &cp.day, ms);
+	toCheckpoint(StatsTier::WEEK, &cp.week, ms);
+	storage->cp_store(&cp);
+}
+
+void TempStats::restore() {
+	StatsCheckpoint cp;
+	if (!storage->cp_load(&cp)) {
 		return;
 	}
-	dp.lastProbeMs = ms;
-
-	if (dp.probeIdx == ST_PROBES_PER_DAY) {
-		Temp temp = { 0, 0, 0, 0 };
-		temp.avg = util_avg_i8(dp.probes, ST_PROBES_PER_DAY);
-		temp.min = util_min_i8(dp.probes, ST_PROBES_PER_DAY);
-		temp.max = util_max_i8(dp.probes, ST_PROBES_PER_DAY);
-		dp.probeIdx = 0;
-
-		storage->dh_store(&temp);
-	} else {
-		int8_t temp = tempSensor->getTemp();
-		dp.probes[dp.probeIdx++] = temp;
+	uint32_t ms = util_ms();
+	fromCheckpoint(StatsTier::DAY, &cp.day, ms);
+	fromCheckpoint(StatsTier::WEEK, &cp.week, ms);
+#if LOG
+	log(F("TES RST %u,%u"), cp.day.count, cp.week.count);
+#endif
+}
+
+inline void TempStats::toCheckpoint(StatsTier tier, TierCheckpoint* cp, uint32_t ms) {
+	TierProbe* tp = &tierProbes[(uint8_t) tier];
+	cp->sum = tp->sum;
+	cp->count = tp->count;
+	cp->min = tp->min;
+	cp->max = tp->max;
+	cp->elapsedMs = tp->count == 0 ? 0 : ms - tp->startMs;
+}
+
+inline void TempStats::fromCheckpoint(StatsTier tier, TierCheckpoint* cp, uint32_t ms) {
+	TierProbe* tp = &tierProbes[(uint8_t) tier];
+	tp->sum = cp->sum;
+	tp->count = cp->count;
+	tp->min = cp->min;
+	tp->max = cp->max;
+	tp->startMs = ms - cp->elapsedMs;
+}
+
+void TempStats::storeTier(StatsTier tier, Temp* temp) {
 #if TRACE
-		log(F("TES DP[%d]=%d"), dp.probeIdx, temp);
+	log(F("TES T%d:%d,%d,%d"), tier, temp->avg, temp->min, temp->max);
+#endif
+	switch (tier) {
+	case StatsTier::MINUTE:
+		minutes.store(temp);
+#if ENABLE_TEMP_LOG
+		mLog.add(temp->avg);
 #endif
+		break;
+	case StatsTier::HOUR:
+		hours.store(temp);
+		break;
+	case StatsTier::DAY:
+		storage->dh_store(temp);
+		break;
+	default:
+		storage->wh_store(temp);
+		break;
+	}
+}
+
+uint16_t TempStats::tierSize(StatsTier tier) {
+	switch (tier) {
+	case StatsTier::MINUTE:
+		return minutes.size();
+	case StatsTier::HOUR:
+		return hours.size();
+	case StatsTier::DAY:
+		return storage->dh_readDays();
+	default:
+		return storage->wh_readWeeks();
+	}
+}
+
+void TempStats::readTier(StatsTier tier, Temp* temp, uint16_t hIdx) {
+	switch (tier) {
+	case StatsTier::MINUTE:
+		minutes.read(temp, hIdx);
+		break;
+	case StatsTier::HOUR:
+		hours.read(temp, hIdx);
+		break;
+	case StatsTier::DAY:
+		storage->dh_read(temp, hIdx);
+		break;
+	default:
+		storage->wh_read(temp, hIdx);
+		break;
 	}
 }
 
-// ################################ DayIteroator ################################
-TempStats::DayIteroator::DayIteroator(TempStats* ts) :
-		ts(ts), dIdx(0) {
+// ################################ TierIterator ################################
+TempStats::TierIterator::TierIterator(TempStats* ts, StatsTier tier) :
+		ts(ts), tier(tier), hIdx(0) {
 }
 
-boolean TempStats::DayIteroator::hasNext() {
-	boolean has = dIdx < ts->storage->dh_readDays();
+boolean TempStats::TierIterator::hasNext() {
+	boolean has = hIdx < ts->tierSize(tier);
 	return has;
 }
 
-boolean TempStats::DayIteroator::hasPrev() {
-	boolean has = dIdx > 0;
+boolean TempStats::TierIterator::hasPrev() {
+	boolean has = hIdx > 0;
 	return has;
 }
 
-Temp* TempStats::DayIteroator::next() {
-	ts->storage->dh_read(&temp, dIdx++);
-	updateDayTemp(&temp);
+Temp* TempStats::TierIterator::next() {
+	ts->readTier(tier, &temp, hIdx++);
+	updateTemp(&temp);
 	return &temp;
 }
 
-Temp* TempStats::DayIteroator::prev() {
-	ts->storage->dh_read(&temp, --dIdx);
-	updateDayTemp(&temp);
+Temp* TempStats::TierIterator::prev() {
+	ts->readTier(tier, &temp, --hIdx);
+	updateTemp(&temp);
 	return &temp;
 }
 
-inline void TempStats::DayIteroator::updateDayTemp(Temp* temp) {
-	temp->day = dIdx;
+inline void TempStats::TierIterator::updateTemp(Temp* temp) {
+	temp->day = hIdx;
 }
 
-void TempStats::DayIteroator::reset() {
-	dIdx = 0;
+void TempStats::TierIterator::reset() {
+	hIdx = 0;
 }
 
-uint8_t TempStats::DayIteroator::size() {
-	return ts->storage->dh_readDays();
+uint16_t TempStats::TierIterator::size() {
+	return ts->tierSize(tier);
 }
 // ##############################################################################
@@ -26,69 +26,111 @@
 #include "ArdLog.h"
 #include "Storage.h"
 #include "StatsData.h"
+#include "TempRing.h"
+#include "RollingMinMax.h"
+#include "TempLog.h"
 
 class TempStats: public Service, public BusListener {
 public:
 	TempStats(TempSensor* tempSensor, Storage* storage);
+
+	/** Min and max over last #ST_ROLLING_MS. */
 	Temp* actual();
 
 	/**
-	 * Day history starts from now, and goes over past days: now, yesterday, before yesterday, ...., 33 days ago, ...
+	 * History of a tier starts from now, and goes over past entries. For days: now, yesterday, before yesterday, ....,
+	 * 33 days ago, ...
 	 */
-	class DayIteroator {
+	class TierIterator {
 	public:
-		DayIteroator(TempStats* ts);
-		/** Go to next entry in history, meaning go back by one day. After reaching history limit dit rotates to "now". */
+		TierIterator(TempStats* ts, StatsTier tier);
+		/** Go to next entry in history, meaning go back in time. After reaching history limit it rotates to "now". */
 		Temp* next();
 
 		boolean hasNext();
 
-		/** Go back in history to more recent day. After reaching "now" dit rotates to the end of the history. */
+		/** Go back in history to more recent entry. After reaching "now" it rotates to the end of the history. */
 		Temp* prev();
 
 		boolean hasPrev();
 
-		/** Resets iterator to day one (now). */
+		/** Resets iterator to entry one (now). */
 		void reset();
 
 		/** Amount of history entries. */
-		uint8_t size();
+		uint16_t size();
 	private:
 		TempStats* ts;
+		const StatsTier tier;
 		Temp temp;
-		uint8_t dIdx;
+		uint16_t hIdx;
 
-		inline void updateDayTemp(Temp* temp);
+		inline void updateTemp(Temp* temp);
 	};
-	DayIteroator* di();
+
+	/** Iterator over days. */
+	TierIterator* di();
+
+	/** Iterator over given tier. */
+	TierIterator* ti(StatsTier tier);
+
+#if ENABLE_TEMP_LOG
+	/** Compressed history of minute averages, longer than minute tier. */
+	TempLog* minuteLog();
+#endif
 	void init();
 private:
+	/** Running avg/min/max of the current entry of a tier, each entry of the finer tier is added as it comes. */
 	typedef struct {
-		/** FIFO Queue containing statistics for each day. Top of the queue has the oldest day, bottom most recent. */
-		int8_t probes[ST_PROBES_PER_DAY];
-		uint8_t probeIdx;
-		uint32_t lastProbeMs;
-	} DayProbe;
+		int32_t sum;
+		uint16_t count;
+		temp_t min;
+		temp_t max;
+		uint32_t startMs;
+	} TierProbe;
 
 	typedef struct {
 		uint32_t lastProbeMs;
-		Temp temp; // actual temp, only min and max are updated.
+		Temp temp; // actual temp, only min and max are updated - from #rolling.
+		RollingMinMax rolling;
 	} ActualProbe;
 
 	TempSensor* tempSensor;
 	Storage* storage;
-	DayIteroator dit;
-	DayProbe dp;
+	TierIterator iterators[(uint8_t) StatsTier::AMOUNT];
+	TierProbe tierProbes[(uint8_t) StatsTier::AMOUNT];
 	ActualProbe ap;
 
+	PackedTemp minuteBuf[ST_MINUTE_HISTORY_SIZE];
+	PackedTemp hourBuf[ST_HOUR_HISTORY_SIZE];
+	TempRing minutes;
+	TempRing hours;
+#if ENABLE_TEMP_LOG
+	TempLog mLog;
+#endif
+
 	uint8_t deviceId();
 	void clearStats();
-	void cycle();
-	uint8_t listenerId();
-	void onEvent(BusEvent event, va_list ap);
-	inline void probeDayTemp();
-	inline void probeActualTemp();
+	uint32_t cycle();
+	void onEvent(const BusMsg* msg);
+
+	inline void probeActualTemp(uint32_t ms, temp_t temp);
+
+	/* Adds entry starting at #startMs to the tier, entry that is over gets stored and added to the next tier first. */
+	void probeTier(StatsTier tier, uint32_t startMs, temp_t avg, temp_t tMin, temp_t tMax);
+	void storeTier(StatsTier tier, Temp* temp);
+	uint16_t tierSize(StatsTier tier);
+	void readTier(StatsTier tier, Temp* temp, uint16_t hIdx);
+	inline void clearTiers();
+
+	/* Unfinished day and week to/from EEPROM. */
+	void checkpoint();
+	void restore();
+	inline void toCheckpoint(StatsTier tier, TierCheckpoint* cp, uint32_t ms);
+	inline void fromCheckpoint(StatsTier tier, TierCheckpoint* cp, uint32_t ms);
 	inline void initTemp(Temp* temp);
 };
 
+static_assert(sizeof(TempStats) <= ST_RAM_BYTES + (ENABLE_TEMP_LOG ? sizeof(TempLog) : 0), "TempStats over RAM budget");
+
 #endif /* TEMPSTATS_H_ */
@@ -0,0 +1,68 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEMPERATURE_H_
+#define TEMPERATURE_H_
+
+#include "Arduino.h"
+
+/**
+ * Temperature in tenths of degree, 215 is 21.5. Degrees are Celsius, or Fahrenheit with USE_FEHRENHEIT. It's integer
+ * all the way from the sensor to the display, so there is no need for floating point on AVR.
+ */
+typedef int16_t temp_t;
+
+/** Amount of #temp_t per degree. */
+const static temp_t TEMP_UNIT = 10;
+
+/** Converts whole degrees to #temp_t, meant for constants. */
+constexpr temp_t temp_deg(int16_t degrees) {
+	return degrees * TEMP_UNIT;
+}
+
+/** Converts raw DS18B20 reading given in 1/128 of degree Celsius, rounding to the nearest tenth. */
+inline temp_t temp_fromRaw(int32_t raw) {
+	int32_t tenths = raw * TEMP_UNIT;
+	return (tenths + (tenths >= 0 ? 64 : -64)) / 128;
+}
+
+/** Converts Celsius to Fahrenheit. */
+inline temp_t temp_toFahrenheit(temp_t temp) {
+	return (int32_t) temp * 9 / 5 + temp_deg(32);
+}
+
+/** Formats temperature as "-12.5" into #buf, it has to have space for at least 7 characters. Returns #buf. */
+inline char* temp_format(char* buf, temp_t temp) {
+	uint16_t abs = temp < 0 ? -temp : temp;
+	sprintf(buf, "%s%u.%u", temp < 0 ? "-" : "", abs / TEMP_UNIT, abs % TEMP_UNIT);
+	return buf;
+}
+
+/**
+ * Formats temperature in at most #TEMP_SHORT_CHARS characters, for the display: with tenth between -9.9 and 99.9,
+ * rounded to whole degrees outside, down to -999 - the top of #temp_t range is 3277. Disconnected DS18B20 (-127) fits too.
+ */
+const static uint8_t TEMP_SHORT_CHARS = 4;
+inline char* temp_formatShort(char* buf, temp_t temp) {
+	if (temp > temp_deg(-10) && temp < temp_deg(100)) {
+		return temp_format(buf, temp);
+	}
+	int16_t deg = (temp + (temp >= 0 ? TEMP_UNIT / 2 : -TEMP_UNIT / 2)) / TEMP_UNIT;
+	sprintf(buf, "%d", max(deg, (int16_t) -999));
+	return buf;
+}
+
+#endif /* TEMPERATURE_H_ */
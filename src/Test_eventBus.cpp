@@ -0,0 +1,184 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ENABLE_TEST_EVENT_BUS
+#define ENABLE_TEST_EVENT_BUS false
+#endif
+
+#if ENABLE_TEST_EVENT_BUS
+
+#include "Arduino.h"
+#include "ArduinoUnit.h"
+#include "Config.h"
+#include "ArdLog.h"
+#include "EventBus.h"
+
+class RecordingListener: public BusListener {
+public:
+	const static uint8_t RECORDS_MAX = 16;
+	BusMsg records[RECORDS_MAX];
+	uint8_t recorded;
+
+	/** Event that will be posted back to the bus when #repostOn has been received. */
+	BusEvent repost;
+	BusEvent repostOn;
+
+	RecordingListener(ListenerSlot slot, BusEventMask events) :
+			BusListener(slot, events), recorded(0), repost(BusEvent::CYCLE), repostOn(BusEvent::CYCLE) {
+	}
+
+	void clear() {
+		recorded = 0;
+	}
+
+	void onEvent(const BusMsg* msg) {
+		if (recorded < RECORDS_MAX) {
+			records[recorded++] = *msg;
+		}
+		if (msg->event == repostOn && repost != repostOn) {
+			eb_post(repost);
+		}
+	}
+};
+
+static RecordingListener *relayListener;
+static RecordingListener *buttonListener;
+
+static void clear() {
+	eb_drain();
+	relayListener->clear();
+	buttonListener->clear();
+}
+
+test(eventBus_mask) {
+	clear();
+	eb_fire(BusEvent::CYCLE);
+	eb_fire(BusEvent::BUTTON_NEXT);
+	eb_fire(BusEvent::RELAY_OFF);
+
+	assertEqual(1, relayListener->recorded);
+	assertTrue(relayListener->records[0].event == BusEvent::RELAY_OFF);
+
+	assertEqual(1, buttonListener->recorded);
+	assertTrue(buttonListener->records[0].event == BusEvent::BUTTON_NEXT);
+}
+
+test(eventBus_payload) {
+	clear();
+	util_setCycleMs(1234);
+
+	BusMsg msg = eb_msg(BusEvent::RELAY_ON, DEVICE_ID_RELAY_DRIVER);
+	msg.data.relayId = 1;
+	eb_fire(&msg);
+
+	assertEqual(1, relayListener->recorded);
+	BusMsg* rec = &relayListener->records[0];
+	assertEqual(DEVICE_ID_RELAY_DRIVER, rec->sourceId);
+	assertEqual(1, rec->data.relayId);
+	assertEqual(1234, rec->ms);
+}
+
+test(eventBus_post_fifo) {
+	clear();
+	eb_post(BusEvent::BUTTON_NEXT);
+	eb_post(BusEvent::BUTTON_PREV);
+	eb_post(BusEvent::BUTTON_NEXT);
+
+	// nothing gets delivered before drain
+	assertEqual(0, buttonListener->recorded);
+	assertTrue(eb_pending());
+
+	eb_drain();
+	assertFalse(eb_pending());
+	assertEqual(3, buttonListener->recorded);
+	assertTrue(buttonListener->records[0].event == BusEvent::BUTTON_NEXT);
+	assertTrue(buttonListener->records[1].event == BusEvent::BUTTON_PREV);
+	assertTrue(buttonListener->records[2].event == BusEvent::BUTTON_NEXT);
+}
+
+test(eventBus_post_full) {
+	clear();
+	uint8_t posted = 0;
+	while (eb_post(BusEvent::BUTTON_PREV)) {
+		posted++;
+	}
+	assertEqual(8, posted);
+
+	eb_drain();
+	assertEqual(posted, buttonListener->recorded);
+
+	// queue is usable again
+	assertTrue(eb_post(BusEvent::BUTTON_PREV));
+	eb_drain();
+	assertEqual(posted + 1, buttonListener->recorded);
+}
+
+test(eventBus_post_from_listener) {
+	clear();
+	buttonListener->repostOn = BusEvent::BUTTON_NEXT;
+	buttonListener->repost = BusEvent::RELAY_ON;
+
+	eb_post(BusEvent::BUTTON_NEXT);
+	eb_drain();
+
+	// message posted while draining waits for next drain
+	assertEqual(1, buttonListener->recorded);
+	assertEqual(0, relayListener->recorded);
+	assertTrue(eb_pending());
+
+	eb_drain();
+	assertEqual(1, relayListener->recorded);
+
+	buttonListener->repostOn = BusEvent::CYCLE;
+	buttonListener->repost = BusEvent::CYCLE;
+}
+
+test(eventBus_register_taken_slot) {
+	clear();
+	RecordingListener* intruder = new RecordingListener(ListenerSlot::DISPLAY, eb_mask(BusEventGroup::RELAY));
+	assertFalse(eb_register(intruder, eb_mask(BusEventGroup::RELAY)));
+
+	// first listener keeps the slot and its events
+	eb_fire(BusEvent::BUTTON_NEXT);
+	eb_fire(BusEvent::RELAY_ON);
+	assertEqual(0, intruder->recorded);
+	assertEqual(1, buttonListener->recorded);
+	assertEqual(1, relayListener->recorded);
+
+	// the same listener can change its events
+	assertTrue(eb_register(buttonListener, eb_mask(BusEventGroup::BUTTON)));
+	delete intruder;
+}
+
+void setup() {
+#if ENABLE_LOGGER
+	log_setup();
+#endif
+
+	// no components are created in this test, so their slots are free
+	relayListener = new RecordingListener(ListenerSlot::RELAY_DRIVER, eb_mask(BusEventGroup::RELAY));
+	buttonListener = new RecordingListener(ListenerSlot::DISPLAY, eb_mask(BusEventGroup::BUTTON));
+
+	Serial.begin(SERIAL_SPEED);
+	while (!Serial) {
+	}
+}
+
+void loop() {
+	Test::run();
+}
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENABLE_TEST_MEDIAN_FILTER
+#define ENABLE_TEST_MEDIAN_FILTER false
+#endif
+
+#if ENABLE_TEST_MEDIAN_FILTER
+
+#include "Arduino.h"
+#include "ArduinoUnit.h"
+#include "Config.h"
+#include "ArdLog.h"
+#include "Util.h"
+#include "MedianFilter.h"
+
+static MedianFilter filter(FilterStage::RAW);
+
+/* Median calculated by sorting copy of last samples, the way TempSensor used to do it. */
+static temp_t sortedMedian(temp_t samples[], uint16_t end) {
+	temp_t window[TS_MEDIAN_WINDOW];
+	uint8_t size = end < TS_MEDIAN_WINDOW ? end : TS_MEDIAN_WINDOW;
+	for (uint8_t i = 0; i < size; i++) {
+		window[i] = samples[end - size + i];
+	}
+	util_sort_i16(window, size);
+	if ((size & 1) == 0) {
+		return ((int32_t) window[size / 2 - 1] + window[size / 2]) / 2;
+	}
+	return window[size / 2];
+}
+
+test(MedianFilter_filling) {
+	filter.clear();
+	assertEqual(temp_deg(20), filter.add(temp_deg(20)));
+	assertEqual(temp_deg(21), filter.add(temp_deg(22)));
+	assertEqual(temp_deg(20), filter.add(temp_deg(-5)));
+	assertEqual(3, filter.size());
+}
+
+test(MedianFilter_spike) {
+	filter.clear();
+	for (uint8_t i = 0; i < TS_MEDIAN_WINDOW; i++) {
+		filter.add(temp_deg(21));
+	}
+
+	// single broken read does not change temperature
+	assertEqual(temp_deg(21), filter.add(temp_deg(-127)));
+	assertEqual(temp_deg(21), filter.add(temp_deg(85)));
+	assertEqual(TS_MEDIAN_WINDOW, filter.size());
+}
+
+test(MedianFilter_random) {
+	const static uint16_t SAMPLES = 500;
+	temp_t samples[SAMPLES];
+	uint32_t seed = 7;
+
+	filter.clear();
+	for (uint16_t i = 0; i < SAMPLES; i++) {
+		seed = seed * 1103515245 + 12345;
+		samples[i] = (int16_t) ((seed >> 16) % 400) - 100;
+		if (i % 50 > 40) {
+			samples[i] = samples[i - 1]; // duplicates
+		}
+		assertEqual(sortedMedian(samples, i + 1), filter.add(samples[i]));
+	}
+}
+
+void setup() {
+#if ENABLE_LOGGER
+	log_setup();
+#endif
+	Serial.begin(SERIAL_SPEED);
+	while (!Serial) {
+	}
+}
+
+void loop() {
+	Test::run();
+}
+
+#endif
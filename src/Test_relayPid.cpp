@@ -0,0 +1,87 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ENABLE_TEST_RELAY_PID
+#define ENABLE_TEST_RELAY_PID false
+#endif
+
+#if ENABLE_TEST_RELAY_PID
+
+#include "Arduino.h"
+#include "ArduinoUnit.h"
+#include "Config.h"
+#include "ArdLog.h"
+#include "RelayPidController.h"
+
+class DummyTempSensor: public TempSensor {
+public:
+	temp_t temp;
+	temp_t getFilteredTemp(FilterStage) {
+		return temp;
+	}
+};
+
+static DummyTempSensor *tempSens;
+const static temp_t SET_POINT = temp_deg(21);
+
+/* Executes controller given amount of times, returns amount of executions that switched relay on. */
+static uint32_t execute(RelayPidController* pid, temp_t temp, uint32_t times) {
+	tempSens->temp = temp;
+	uint32_t on = 0;
+	for (uint32_t i = 0; i < times; i++) {
+		if (pid->execute() == Relay::State::ON) {
+			on++;
+		}
+	}
+	return on;
+}
+
+test(relayPid_windup) {
+	RelayPidController pid(tempSens, SET_POINT);
+
+	// far above set point for a long time: sum of errors in tenths would overflow int32 without the limit
+	const uint32_t times = 3000000;
+	assertEqual(times, execute(&pid, SET_POINT + temp_deg(100), times));
+
+	// slightly below set point: relay goes off within few executions, not after the saturation has been unwound
+	execute(&pid, SET_POINT - temp_deg(2), 5);
+	assertEqual(0, execute(&pid, SET_POINT - temp_deg(2), 100));
+}
+
+test(relayPid_switch) {
+	RelayPidController pid(tempSens, SET_POINT);
+	assertEqual(0, execute(&pid, SET_POINT - temp_deg(5), 100));
+	execute(&pid, SET_POINT + temp_deg(5), 5);
+	assertEqual(100, execute(&pid, SET_POINT + temp_deg(5), 100));
+}
+
+void setup() {
+#if ENABLE_LOGGER
+	log_setup();
+#endif
+
+	tempSens = new DummyTempSensor();
+
+	Serial.begin(SERIAL_SPEED);
+	while (!Serial) {
+	}
+}
+
+void loop() {
+	Test::run();
+}
+
+#endif
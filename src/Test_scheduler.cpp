@@ -0,0 +1,204 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ENABLE_TEST_SCHEDULER
+#define ENABLE_TEST_SCHEDULER false
+#endif
+
+#if ENABLE_TEST_SCHEDULER
+
+#include "Arduino.h"
+#include "ArduinoUnit.h"
+#include "Config.h"
+#include "ArdLog.h"
+#include "Scheduler.h"
+
+/** Records order of execution into #runs. */
+class OrderTask: public Task {
+public:
+	const uint8_t id;
+	uint32_t delayMs;
+
+	static uint8_t runs[8];
+	static uint8_t runsCnt;
+
+	OrderTask(uint8_t id) :
+			id(id), delayMs(SC_NEVER), next(NULL) {
+	}
+
+	/** Task scheduled with 0 delay from #run(). */
+	Task* next;
+
+	uint32_t run() {
+		if (runsCnt < 8) {
+			runs[runsCnt++] = id;
+		}
+		if (next != NULL) {
+			sc_schedule(next, 0);
+		}
+		return delayMs;
+	}
+};
+
+uint8_t OrderTask::runs[8];
+uint8_t OrderTask::runsCnt = 0;
+
+static OrderTask *t1;
+static OrderTask *t2;
+static OrderTask *t3;
+
+static void reset() {
+	sc_cancel(t1);
+	sc_cancel(t2);
+	sc_cancel(t3);
+	t1->delayMs = t2->delayMs = t3->delayMs = SC_NEVER;
+	t1->next = t2->next = t3->next = NULL;
+	OrderTask::runsCnt = 0;
+}
+
+test(scheduler_order) {
+	reset();
+	util_setCycleMs(1000);
+	sc_schedule(t1, 30);
+	sc_schedule(t2, 10);
+	sc_schedule(t3, 20);
+	assertEqual(10, sc_nextMs());
+
+	util_setCycleMs(1015);
+	sc_dispatch();
+	assertEqual(1, OrderTask::runsCnt);
+	assertEqual(2, OrderTask::runs[0]);
+	assertEqual(5, sc_nextMs());
+
+	util_setCycleMs(1100);
+	sc_dispatch();
+	assertEqual(3, OrderTask::runsCnt);
+	assertEqual(3, OrderTask::runs[1]);
+	assertEqual(1, OrderTask::runs[2]);
+	assertEqual(SC_NEVER, sc_nextMs());
+}
+
+test(scheduler_periodic) {
+	reset();
+	util_setCycleMs(2000);
+	t1->delayMs = 100;
+	sc_schedule(t1, 0);
+
+	for (uint8_t i = 0; i < 5; i++) {
+		sc_dispatch();
+		assertEqual(100, sc_nextMs());
+		util_setCycleMs(util_ms() + 100);
+	}
+	assertEqual(5, OrderTask::runsCnt);
+}
+
+test(scheduler_cancel_move) {
+	reset();
+	util_setCycleMs(3000);
+	sc_schedule(t1, 10);
+	sc_schedule(t2, 20);
+	sc_schedule(t3, 30);
+
+	sc_cancel(t1);
+	sc_schedule(t3, 5);
+	assertEqual(5, sc_nextMs());
+
+	util_setCycleMs(3050);
+	sc_dispatch();
+	assertEqual(2, OrderTask::runsCnt);
+	assertEqual(3, OrderTask::runs[0]);
+	assertEqual(2, OrderTask::runs[1]);
+}
+
+test(scheduler_ms_overflow) {
+	reset();
+	util_setCycleMs(0xFFFFFFF0);
+	sc_schedule(t1, 0x20);
+	assertEqual(0x20, sc_nextMs());
+
+	util_setCycleMs(0x08);
+	sc_dispatch();
+	assertEqual(0, OrderTask::runsCnt);
+
+	util_setCycleMs(0x10);
+	sc_dispatch();
+	assertEqual(1, OrderTask::runsCnt);
+}
+
+test(scheduler_zero_delay) {
+	reset();
+	util_setCycleMs(4000);
+	t1->delayMs = 0;
+	t2->next = t2;
+	t3->next = t1;
+	sc_schedule(t1, 0);
+	sc_schedule(t2, 0);
+	sc_schedule(t3, 0);
+
+	// each task runs once, also when it returns 0 or gets scheduled again by itself or another task
+	sc_dispatch();
+	assertEqual(3, OrderTask::runsCnt);
+	assertEqual(0, sc_nextMs());
+
+	// t3 returns SC_NEVER and nothing schedules it
+	sc_dispatch();
+	assertEqual(5, OrderTask::runsCnt);
+
+	sc_cancel(t2);
+	sc_dispatch();
+	assertEqual(6, OrderTask::runsCnt);
+	assertEqual(1, OrderTask::runs[5]);
+}
+
+test(scheduler_full) {
+	reset();
+	util_setCycleMs(5000);
+	const uint8_t amount = static_cast<uint8_t>(ListenerSlot::AMOUNT) + 1;
+	OrderTask* tasks[amount];
+	for (uint8_t idx = 0; idx < amount; idx++) {
+		tasks[idx] = new OrderTask(10 + idx);
+		assertTrue(sc_schedule(tasks[idx], 10));
+	}
+	assertFalse(sc_schedule(t1, 5));
+	assertEqual(10, sc_nextMs());
+
+	// already scheduled task can be moved
+	assertTrue(sc_schedule(tasks[0], 5));
+	for (uint8_t idx = 0; idx < amount; idx++) {
+		delete tasks[idx];
+	}
+	assertTrue(sc_schedule(t1, 5));
+}
+
+void setup() {
+#if ENABLE_LOGGER
+	log_setup();
+#endif
+
+	t1 = new OrderTask(1);
+	t2 = new OrderTask(2);
+	t3 = new OrderTask(3);
+
+	Serial.begin(SERIAL_SPEED);
+	while (!Serial) {
+	}
+}
+
+void loop() {
+	Test::run();
+}
+
+#endif
@@ -15,7 +15,9 @@
  * limitations under the License.
  */
 
+#ifndef ENABLE_TEST_STORAGE
 #define ENABLE_TEST_STORAGE false
+#endif
 
 #if ENABLE_TEST_STORAGE
 
@@ -39,7 +41,7 @@ test(storage) {
 	storage->dh_clear();
 	for (uint8_t i = 0; i < STORAGE_DAYS; i++) {
 		temp.avg = i;
-		temp.min = 10 + i;
+		temp.min = -10 - i;
 		temp.max = 20 + i;
 		storage->dh_store(&temp);
 	}
@@ -50,12 +52,158 @@ test(storage) {
 	for (uint8_t i = 0; i < STORAGE_DAYS; i++) {
 		storage->dh_read(&temp, i);
 		assertEqual(tempCnt, temp.avg);
-		assertEqual(10 + tempCnt, temp.min);
+		assertEqual(-10 - tempCnt, temp.min);
 		assertEqual(20 + tempCnt, temp.max);
 		tempCnt--;
 	}
 }
 
+test(storage_full) {
+	Temp temp = { 0, 0, 0, 0 };
+
+	// full history drops the oldest entries
+	storage->dh_clear();
+	for (uint8_t i = 0; i < ST_WEEK_HISTORY_SIZE + 5; i++) {
+		temp.avg = i;
+		storage->wh_store(&temp);
+	}
+	assertEqual(ST_WEEK_HISTORY_SIZE, storage->wh_readWeeks());
+	assertEqual(0, storage->dh_readDays());
+
+	storage->wh_read(&temp, 0);
+	assertEqual(ST_WEEK_HISTORY_SIZE + 4, temp.avg);
+	storage->wh_read(&temp, ST_WEEK_HISTORY_SIZE - 1);
+	assertEqual(5, temp.avg);
+
+	// circular log is found again after reboot
+	Storage rebooted;
+	assertEqual(ST_WEEK_HISTORY_SIZE, rebooted.wh_readWeeks());
+	rebooted.wh_read(&temp, 0);
+	assertEqual(ST_WEEK_HISTORY_SIZE + 4, temp.avg);
+	rebooted.wh_read(&temp, ST_WEEK_HISTORY_SIZE - 1);
+	assertEqual(5, temp.avg);
+}
+
+test(storage_torn) {
+	Temp temp = { 0, 0, 0, 0 };
+	storage->dh_clear();
+	for (uint16_t i = 0; i < Storage::DAY_CAPACITY + 3; i++) {
+		temp.avg = i;
+		storage->dh_store(&temp);
+	}
+
+	// power lost while writing next entry: sequence number of its slot (the oldest entry) has been cleared only,
+	// first just one byte of it
+	ee_flush();
+	uint16_t eIdx = Storage::EIDX_DAYS_START + 3 * Storage::SLOT_SIZE;
+	for (uint8_t bIdx = 0; bIdx < 2; bIdx++) {
+		EEPROM.write(eIdx + bIdx, 0);
+		Storage rebooted;
+		assertEqual(Storage::DAY_CAPACITY - 1, rebooted.dh_readDays());
+		rebooted.dh_read(&temp, 0);
+		assertEqual(Storage::DAY_CAPACITY + 2, temp.avg);
+		rebooted.dh_read(&temp, Storage::DAY_CAPACITY - 2);
+		assertEqual(4, temp.avg);
+	}
+}
+
+test(storage_cache) {
+	Temp temp = { 0, 0, 0, 0 };
+	storage->dh_clear();
+	for (uint8_t i = 0; i < ST_READ_CACHE_SIZE * 3; i++) {
+		temp.avg = i;
+		storage->dh_store(&temp);
+	}
+
+	// paging goes over cached blocks in both directions
+	for (uint8_t dIdx = 0; dIdx < ST_READ_CACHE_SIZE * 3; dIdx++) {
+		storage->dh_read(&temp, dIdx);
+		assertEqual(ST_READ_CACHE_SIZE * 3 - 1 - dIdx, temp.avg);
+	}
+	storage->dh_read(&temp, 1);
+	assertEqual(ST_READ_CACHE_SIZE * 3 - 2, temp.avg);
+
+	// new entry goes into the cached block, older entries move
+	temp.avg = 100;
+	storage->dh_store(&temp);
+	storage->dh_read(&temp, 0);
+	assertEqual(100, temp.avg);
+	storage->dh_read(&temp, 2);
+	assertEqual(ST_READ_CACHE_SIZE * 3 - 2, temp.avg);
+
+	// weeks do not share block with days
+	temp.avg = 200;
+	storage->wh_store(&temp);
+	storage->wh_read(&temp, 0);
+	assertEqual(200, temp.avg);
+	storage->dh_read(&temp, 1);
+	assertEqual(ST_READ_CACHE_SIZE * 3 - 1, temp.avg);
+}
+
+test(storage_schema) {
+	Temp temp = { 10, 5, 20, 0 };
+	storage->dh_clear();
+	storage->dh_store(&temp);
+	ee_flush();
+	assertEqual(1, Storage().dh_readDays());
+
+	// EEPROM written by another version of the firmware gets cleared
+	EEPROM.write(Storage::EIDX_SCHEMA_VERSION, EEPROM.read(Storage::EIDX_SCHEMA_VERSION) + 1);
+	Storage rebooted;
+	assertEqual(0, rebooted.dh_readDays());
+	ee_flush();
+	assertEqual(0, Storage().dh_readDays());
+}
+
+test(storage_checkpoint) {
+	StatsCheckpoint cp = { { -100000, 10, -5, 25, 3600000 }, { 2000, 3, 10, 30, 90000000 } };
+
+	storage->dh_clear();
+	assertEqual(false, storage->cp_load(&cp));
+
+	// more checkpoints than slots, the last one survives reboot
+	for (uint8_t i = 0; i < ST_CHECKPOINT_SLOTS * 2 + 3; i++) {
+		cp.day.count = i;
+		storage->cp_store(&cp);
+	}
+	Storage rebooted;
+	StatsCheckpoint loaded;
+	assertEqual(true, rebooted.cp_load(&loaded));
+	assertEqual(ST_CHECKPOINT_SLOTS * 2 + 2, loaded.day.count);
+	assertEqual(-100000, loaded.day.sum);
+	assertEqual(-5, loaded.day.min);
+	assertEqual(3600000, loaded.day.elapsedMs);
+	assertEqual(2000, loaded.week.sum);
+	assertEqual(30, loaded.week.max);
+	assertEqual(90000000, loaded.week.elapsedMs);
+
+	rebooted.dh_clear();
+	assertEqual(false, rebooted.cp_load(&loaded));
+}
+
+test(storage_eepromWriter) {
+	ee_flush();
+	uint32_t writes = ee_writes();
+	uint32_t saved = ee_saved();
+	uint8_t val = EEPROM.read(E2END) + 1;
+
+	// the second write to the same cell replaces the queued one, nothing reaches EEPROM before flush
+	ee_write(E2END, val - 1);
+	ee_write(E2END, val);
+	assertEqual(val, ee_read(E2END));
+	assertEqual((uint8_t) (val - 1), EEPROM.read(E2END));
+	ee_flush();
+	assertEqual(val, EEPROM.read(E2END));
+	assertEqual(writes + 1, ee_writes());
+	assertEqual(saved + 1, ee_saved());
+
+	// unchanged content is not written
+	ee_write(E2END, val);
+	ee_flush();
+	assertEqual(writes + 1, ee_writes());
+	assertEqual(saved + 2, ee_saved());
+}
+
 void setup() {
 #if ENABLE_LOGGER
 	log_setup();
@@ -0,0 +1,89 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENABLE_TEST_TEMP_FILTER
+#define ENABLE_TEST_TEMP_FILTER false
+#endif
+
+#if ENABLE_TEST_TEMP_FILTER
+
+#include "Arduino.h"
+#include "ArduinoUnit.h"
+#include "Config.h"
+#include "ArdLog.h"
+#include "Util.h"
+#include "TempFilter.h"
+
+test(SpikeFilter_dropsSpike) {
+	SpikeFilter filter(FilterStage::RAW);
+	assertEqual(temp_deg(21), filter.add(temp_deg(21)));
+	assertEqual(temp_deg(21), filter.add(temp_deg(85)));
+	assertEqual(temp_deg(21), filter.add(temp_deg(-127)));
+	assertEqual(215, filter.add(215));
+}
+
+test(SpikeFilter_followsStep) {
+	SpikeFilter filter(FilterStage::RAW);
+	filter.add(temp_deg(21));
+	for (uint8_t i = 1; i < TF_SPIKE_HOLD; i++) {
+		assertEqual(temp_deg(21), filter.add(temp_deg(30)));
+	}
+	assertEqual(temp_deg(30), filter.add(temp_deg(30)));
+}
+
+test(EmaFilter_converges) {
+	EmaFilter filter(FilterStage::RAW);
+	assertEqual(temp_deg(20), filter.add(temp_deg(20)));
+
+	temp_t prev = temp_deg(20);
+	for (uint8_t i = 0; i < 40; i++) {
+		temp_t temp = filter.add(temp_deg(-10));
+		assertTrue(temp <= prev);
+		prev = temp;
+	}
+	assertEqual(temp_deg(-10), prev);
+}
+
+test(KalmanFilter_converges) {
+	KalmanFilter filter(FilterStage::RAW);
+	assertEqual(temp_deg(20), filter.add(temp_deg(20)));
+
+	// alternating noise around 22.0 averages out
+	temp_t temp = 0;
+	for (uint8_t i = 0; i < 200; i++) {
+		temp = filter.add(temp_deg(22) + ((i & 1) ? 5 : -5));
+	}
+	assertTrue(util_abs16(temp - temp_deg(22)) <= 1);
+
+	filter.clear();
+	assertEqual(temp_deg(-5), filter.add(temp_deg(-5)));
+}
+
+void setup() {
+#if ENABLE_LOGGER
+	log_setup();
+#endif
+	Serial.begin(SERIAL_SPEED);
+	while (!Serial) {
+	}
+}
+
+void loop() {
+	Test::run();
+}
+
+#endif
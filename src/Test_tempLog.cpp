@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENABLE_TEST_TEMP_LOG
+#define ENABLE_TEST_TEMP_LOG false
+#endif
+
+#if ENABLE_TEST_TEMP_LOG
+
+#include "Arduino.h"
+#include "ArduinoUnit.h"
+#include "Config.h"
+#include "ArdLog.h"
+#include "TempLog.h"
+
+static TempLog tempLog;
+
+/* Temperature for sample i: slow changes with jumps of different size. */
+static temp_t sampleTemp(uint16_t i) {
+	if (i % 97 == 0) {
+		return temp_deg(-55);
+	}
+	if (i % 31 == 0) {
+		return temp_deg(40) + i % 7;
+	}
+	return temp_deg(20) + (i / 10) % 30 - (i % 5 == 0 ? 3 : 0);
+}
+
+test(TempLog_roundTrip) {
+	tempLog.clear();
+	for (uint16_t i = 0; i < 300; i++) {
+		tempLog.add(sampleTemp(i));
+	}
+	assertEqual(300, tempLog.size());
+
+	TempLog::Reader reader(&tempLog);
+	for (uint16_t i = 0; i < 300; i++) {
+		assertTrue(reader.hasNext());
+		assertEqual(sampleTemp(i), reader.next());
+	}
+	assertEqual(false, reader.hasNext());
+}
+
+test(TempLog_dropsOldest) {
+	tempLog.clear();
+	const static uint16_t SAMPLES = 20000;
+	for (uint16_t i = 0; i < SAMPLES; i++) {
+		tempLog.add(sampleTemp(i));
+	}
+	uint16_t size = tempLog.size();
+	assertTrue(size > 0 && size < SAMPLES);
+	assertTrue(tempLog.bytes() <= sizeof(tempLog));
+
+	// newest samples in order
+	TempLog::Reader reader(&tempLog);
+	for (uint16_t i = SAMPLES - size; i < SAMPLES; i++) {
+		assertEqual(sampleTemp(i), reader.next());
+	}
+	assertEqual(false, reader.hasNext());
+}
+
+test(TempLog_constant) {
+	tempLog.clear();
+	for (uint16_t i = 0; i < 1440; i++) {
+		tempLog.add(temp_deg(21));
+	}
+
+	// one bit per sample
+	assertEqual(1440, tempLog.size());
+	assertTrue(tempLog.bytes() < 1440 / 8 + 2 * 5 * TL_BLOCKS);
+}
+
+void setup() {
+#if ENABLE_LOGGER
+	log_setup();
+#endif
+	Serial.begin(SERIAL_SPEED);
+	while (!Serial) {
+	}
+}
+
+void loop() {
+	Test::run();
+}
+
+#endif
@@ -0,0 +1,146 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ENABLE_TEST_TEMP_SENSOR
+#define ENABLE_TEST_TEMP_SENSOR false
+#endif
+
+/* Host only: sensors on the bus are simulated over Host.h. */
+#if ENABLE_TEST_TEMP_SENSOR
+
+#include "Arduino.h"
+#include "ArduinoUnit.h"
+#include "Config.h"
+#include "ArdLog.h"
+#include "Host.h"
+#include "TempSensor.h"
+
+/* Delay returned by the last TempSensor#run(), it passes before the next one. */
+static uint32_t delayMs = 0;
+
+/* Executes the sensor as the scheduler would until it reads the next probe. */
+static void probe(TempSensor* sensor) {
+	Task* task = sensor;
+	uint32_t probes = sensor->getProbes();
+	while (sensor->getProbes() == probes) {
+		host_advanceMs(delayMs);
+		util_cycle();
+		delayMs = task->run();
+	}
+}
+
+static TempSensor* createSensor(uint8_t sensors) {
+	host_setSensors(sensors);
+	for (uint8_t sIdx = 0; sIdx < sensors; sIdx++) {
+		host_setSensorTempC(sIdx, 20);
+	}
+	delayMs = 0;
+	TempSensor* sensor = new TempSensor();
+	sensor->init();
+	return sensor;
+}
+
+test(tempSensor_multi) {
+	TempSensor* sensor = createSensor(3);
+	assertEqual(3, sensor->getSensorsAmount());
+	uint32_t searches = host_busSearches();
+
+	host_setSensorTempC(0, 21.5);
+	host_setSensorTempC(1, -7.5);
+	host_setSensorTempC(2, 30);
+	uint32_t conversions = host_conversions();
+	for (uint8_t i = 0; i < 5; i++) {
+		probe(sensor);
+	}
+
+	assertEqual(215, sensor->getSensorTemp(0));
+	assertEqual(-75, sensor->getSensorTemp(1));
+	assertEqual(300, sensor->getSensorTemp(2));
+	assertEqual(215, sensor->getQuickTemp());
+
+	// single convert T for all sensors per probe, sensors are read by cached address
+	assertEqual(5, host_conversions() - conversions);
+	assertEqual(searches, host_busSearches());
+	delete sensor;
+}
+
+test(tempSensor_max_sensors) {
+	TempSensor* sensor = createSensor(TS_SENSORS_MAX + 2);
+	assertEqual(TS_SENSORS_MAX, sensor->getSensorsAmount());
+
+	host_setSensorTempC(TS_SENSORS_MAX - 1, 25);
+	probe(sensor);
+	assertEqual(250, sensor->getSensorTemp(TS_SENSORS_MAX - 1));
+	delete sensor;
+}
+
+test(tempSensor_disconnected) {
+	TempSensor* sensor = createSensor(0);
+	assertEqual(0, sensor->getSensorsAmount());
+
+	probe(sensor);
+	assertEqual(temp_fromRaw(DEVICE_DISCONNECTED_RAW), sensor->getQuickTemp());
+	delete sensor;
+}
+
+test(tempSensor_adaptive_probe) {
+	TempSensor* sensor = createSensor(1);
+	uint32_t minProbeMs = sensor->getProbeMs();
+	assertEqual(750, minProbeMs); // conversion at 12 bits is longer than TS_PROBE_FREQ_MS
+
+	// constant temperature: period doubles after each TS_STABLE_PROBES up to TS_PROBE_MAX_MS
+	uint32_t expectedMs = minProbeMs;
+	while (expectedMs < TS_PROBE_MAX_MS) {
+		for (uint8_t i = 0; i < TS_STABLE_PROBES; i++) {
+			assertEqual(expectedMs, sensor->getProbeMs());
+			probe(sensor);
+		}
+		expectedMs = min(expectedMs * 2, TS_PROBE_MAX_MS);
+	}
+	assertEqual(TS_PROBE_MAX_MS, sensor->getProbeMs());
+	for (uint8_t i = 0; i < TS_STABLE_PROBES * 2; i++) {
+		probe(sensor);
+	}
+	assertEqual(TS_PROBE_MAX_MS, sensor->getProbeMs());
+
+	// probes are taken in that period
+	uint32_t ms = millis();
+	probe(sensor);
+	assertEqual(TS_PROBE_MAX_MS, millis() - ms);
+
+	// step change brings the shortest period back
+	host_setTempC(25);
+	probe(sensor);
+	assertEqual(minProbeMs, sensor->getProbeMs());
+	delete sensor;
+}
+
+void setup() {
+#if ENABLE_LOGGER
+	log_setup();
+#endif
+
+	Serial.begin(SERIAL_SPEED);
+	while (!Serial) {
+	}
+}
+
+void loop() {
+	Test::run();
+	host_setSensors(1);
+}
+
+#endif
@@ -15,7 +15,9 @@
  * limitations under the License.
  */
 
+#ifndef ENABLE_TEST_STATS
 #define ENABLE_TEST_STATS false
+#endif
 
 #if ENABLE_TEST_STATS
 
@@ -27,18 +29,23 @@
 #include "Util.h"
 #include "TempSensor.h"
 #include "TempStats.h"
+#include "Scheduler.h"
 
 class DummyTempSensor: public TempSensor {
 public:
-	int8_t temp;
-	int8_t getTemp() {
+	temp_t temp;
+	temp_t getTemp() {
 		return temp;
 	}
-	int8_t getQuickTemp() {
+	temp_t getQuickTemp() {
 		return temp;
 	}
 };
 
+/* Test day has 24 probes, each one taken after a bit more than an hour. */
+const static uint8_t PROBES_PER_DAY = 24;
+const static uint32_t PROBE_MS = ST_DAY_MS / PROBES_PER_DAY + 100;
+
 static Storage *storage;
 static TempStats *tempStats;
 static DummyTempSensor *tempSens;
@@ -48,100 +55,106 @@ static void createDayStats() {
 
 	assertEqual(0, storage->dh_readDays());
 
-	uint32_t ms = ST_DAY_PROBE_MS + 100;
+	uint32_t ms = util_ms() + PROBE_MS;
 	util_setCycleMs(ms);
 
 	// first day
-	for (uint8_t dd = 0; dd <= ST_PROBES_PER_DAY; dd++) {
+	for (uint8_t dd = 0; dd < PROBES_PER_DAY; dd++) {
 		uint8_t mod = dd % 3;
 		if (mod == 0) {
-			tempSens->temp = -2;
+			tempSens->temp = temp_deg(-2);
 
 		} else if (mod == 1) {
-			tempSens->temp = 5;
+			tempSens->temp = temp_deg(5);
 
 		} else if (mod == 2) {
-			tempSens->temp = 21;
+			tempSens->temp = temp_deg(21);
 		}
 
-		util_setCycleMs(ms += ST_DAY_PROBE_MS + 100);
-		eb_fire(BusEvent::CYCLE);
+		util_setCycleMs(ms += PROBE_MS);
+		sc_dispatch();
 	}
 
 	// second day
-	for (uint8_t dd = 0; dd <= ST_PROBES_PER_DAY; dd++) {
+	for (uint8_t dd = 0; dd < PROBES_PER_DAY; dd++) {
 		uint8_t mod = dd % 3;
 		if (mod == 0) {
-			tempSens->temp = 21;
+			tempSens->temp = temp_deg(21);
 
 		} else if (mod == 1) {
-			tempSens->temp = 5;
+			tempSens->temp = temp_deg(5);
 
 		} else if (mod == 2) {
-			tempSens->temp = 33;
+			tempSens->temp = temp_deg(33);
 		}
 
-		util_setCycleMs(ms += ST_DAY_PROBE_MS + 100);
-		eb_fire(BusEvent::CYCLE);
+		util_setCycleMs(ms += PROBE_MS);
+		sc_dispatch();
 	}
 
 	// third day
-	for (uint8_t dd = 0; dd <= ST_PROBES_PER_DAY; dd++) {
+	for (uint8_t dd = 0; dd < PROBES_PER_DAY; dd++) {
 		uint8_t mod = dd % 3;
 		if (mod == 0) {
-			tempSens->temp = 21;
+			tempSens->temp = temp_deg(21);
 
 		} else if (mod == 1) {
-			tempSens->temp = 31;
+			tempSens->temp = temp_deg(31);
 		}
 
-		util_setCycleMs(ms += ST_DAY_PROBE_MS + 100);
-		eb_fire(BusEvent::CYCLE);
+		util_setCycleMs(ms += PROBE_MS);
+		sc_dispatch();
 	}
 
 	// fourth day
-	for (uint8_t dd = 0; dd <= ST_PROBES_PER_DAY; dd++) {
+	for (uint8_t dd = 0; dd < PROBES_PER_DAY; dd++) {
 		uint8_t mod = dd % 3;
 		if (mod == 0) {
-			tempSens->temp = 13;
+			tempSens->temp = temp_deg(13);
 
 		} else if (mod == 1) {
-			tempSens->temp = 25;
+			tempSens->temp = temp_deg(25);
 		}
 
-		util_setCycleMs(ms += ST_DAY_PROBE_MS + 100);
-		eb_fire(BusEvent::CYCLE);
+		util_setCycleMs(ms += PROBE_MS);
+		sc_dispatch();
+	}
+
+	// first probe of the next day closes the fourth one, it goes through minute and hour tier first
+	for (uint8_t tIdx = 0; tIdx <= (uint8_t) StatsTier::DAY; tIdx++) {
+		util_setCycleMs(ms += PROBE_MS);
+		sc_dispatch();
 	}
 
 	assertEqual(4, storage->dh_readDays());
 }
 
 static void testTempFirstDay(Temp *temp) {
-	assertEqual(-2, temp->min);
-	assertEqual(21, temp->max);
-	assertEqual(8, temp->avg);
+	assertEqual(temp_deg(-2), temp->min);
+	assertEqual(temp_deg(21), temp->max);
+	assertEqual(temp_deg(8), temp->avg);
 }
 
 static void testTempSecondDay(Temp *temp) {
-	assertEqual(5, temp->min);
-	assertEqual(33, temp->max);
-	assertEqual(20, temp->avg);
+	assertEqual(temp_deg(5), temp->min);
+	assertEqual(temp_deg(33), temp->max);
+	assertEqual(197, temp->avg);
 }
 
 static void testTempThirdDay(Temp *temp) {
-	assertEqual(21, temp->min);
-	assertEqual(31, temp->max);
-	assertEqual(28, temp->avg);
+	assertEqual(temp_deg(21), temp->min);
+	assertEqual(temp_deg(31), temp->max);
+	assertEqual(277, temp->avg);
 }
 
 static void testTempFourthdDay(Temp *temp) {
-	assertEqual(13, temp->min);
-	assertEqual(25, temp->max);
-	assertEqual(21, temp->avg);
+	assertEqual(temp_deg(13), temp->min);
+	assertEqual(temp_deg(25), temp->max);
+	assertEqual(temp_deg(21), temp->avg);
 }
 
 static void testForward() {
-	TempStats::DayIteroator* it = tempStats->di();
+	TempStats::TierIterator* it = tempStats->di();
 
 	assertEqual(true, it->hasNext());
 	assertEqual(false, it->hasPrev());
@@ -174,7 +187,7 @@ static void testForward() {
 }
 
 static void testBackwards() {
-	TempStats::DayIteroator* it = tempStats->di();
+	TempStats::TierIterator* it = tempStats->di();
 
 	assertEqual(false, it->hasNext());
 	assertEqual(true, it->hasPrev());
@@ -214,7 +227,7 @@ test(TempStats_it_loop) {
 
 test(TempStats_it_backwards) {
 	eb_fire(BusEvent::CLEAR_STATS);
-	TempStats::DayIteroator* it = tempStats->di();
+	TempStats::TierIterator* it = tempStats->di();
 	createDayStats();
 
 	for (uint8_t i = 0; i < 4; i++) {
@@ -251,34 +264,111 @@ test(TempStats_dayTemp) {
 }
 
 test(TempStats_actualTemp) {
-	uint32_t ms = ST_ACTUAL_PROBE_MS + 100;
+	uint32_t ms = util_ms() + ST_ACTUAL_PROBE_MS + 100;
 	util_setCycleMs(ms);
 	eb_fire(BusEvent::CLEAR_STATS);
 
 	// probe -13
-	tempSens->temp = -13;
-	eb_fire(BusEvent::CYCLE);
+	tempSens->temp = temp_deg(-13);
+	sc_dispatch();
 	Temp *at = tempStats->actual();
-	assertEqual(-13, at->max);
-	assertEqual(-13, at->min);
+	assertEqual(temp_deg(-13), at->max);
+	assertEqual(temp_deg(-13), at->min);
 
 	// probe 21
 	util_setCycleMs(ms += ST_ACTUAL_PROBE_MS + 100);
-	tempSens->temp = 21;
-	eb_fire(BusEvent::CYCLE);
+	tempSens->temp = temp_deg(21);
+	sc_dispatch();
+	at = tempStats->actual();
+	assertEqual(temp_deg(21), at->max);
+	assertEqual(temp_deg(-13), at->min);
+
+	// -13 leaves the window after a day
+	util_setCycleMs(ms += ST_ROLLING_MS + 100);
+	tempSens->temp = temp_deg(15);
+	sc_dispatch();
 	at = tempStats->actual();
-	assertEqual(21, at->max);
-	assertEqual(-13, at->min);
+	assertEqual(temp_deg(15), at->max);
+	assertEqual(temp_deg(15), at->min);
+}
+
+test(TempStats_tiers) {
+	eb_fire(BusEvent::CLEAR_STATS);
+
+	// each probe is a bit more than a day after previous one, so it closes entry in each tier, with one probe delay
+	uint32_t ms = util_ms() + ST_DAY_MS + 100;
+	for (uint8_t dd = 0; dd <= 10; dd++) {
+		tempSens->temp = temp_deg(dd);
+		util_setCycleMs(ms += ST_DAY_MS + 100);
+		sc_dispatch();
+	}
+	assertEqual(10, tempStats->ti(StatsTier::MINUTE)->size());
+	assertEqual(9, tempStats->ti(StatsTier::HOUR)->size());
+	assertEqual(8, tempStats->ti(StatsTier::DAY)->size());
+	assertEqual(1, tempStats->ti(StatsTier::WEEK)->size());
+
+	TempStats::TierIterator* it = tempStats->ti(StatsTier::HOUR);
+	it->reset();
+	assertEqual(temp_deg(8), it->next()->avg);
+
+	// first week has days 0-6
+	it = tempStats->ti(StatsTier::WEEK);
+	it->reset();
+	Temp *temp = it->next();
+	assertEqual(temp_deg(3), temp->avg);
+	assertEqual(temp_deg(0), temp->min);
+	assertEqual(temp_deg(6), temp->max);
+	assertEqual(false, it->hasNext());
+}
+
+test(TempStats_hours) {
+	eb_fire(BusEvent::CLEAR_STATS);
+
+	// each probe is a bit more than an hour after previous one, it closes a minute and, with one probe delay, an hour
+	uint32_t ms = util_ms() + ST_HOUR_MS + 100;
+	for (uint8_t hh = 0; hh < ST_HOUR_HISTORY_SIZE + 5; hh++) {
+		tempSens->temp = temp_deg(hh % 30);
+		util_setCycleMs(ms += ST_HOUR_MS + 100);
+		sc_dispatch();
+	}
+	TempStats::TierIterator* it = tempStats->ti(StatsTier::HOUR);
+	assertEqual(48, it->size());
+	it->reset();
+	assertEqual(temp_deg((ST_HOUR_HISTORY_SIZE + 2) % 30), it->next()->avg);
+}
+
+test(TempRing_packed) {
+	PackedTemp buf[2];
+	TempRing ring(buf, 2);
+	Temp temp = { 215, 200, 230, 0 };
+	ring.store(&temp);
+
+	// min and max further than 25.5 degrees from the average are cut
+	temp = { -100, -400, 300, 0 };
+	ring.store(&temp);
+	temp = { 10, -20, 10, 0 };
+	ring.store(&temp);
+	assertEqual(2, ring.size());
+
+	ring.read(&temp, 0);
+	assertEqual(10, temp.avg);
+	assertEqual(-20, temp.min);
+	assertEqual(10, temp.max);
+
+	ring.read(&temp, 1);
+	assertEqual(-100, temp.avg);
+	assertEqual(-355, temp.min);
+	assertEqual(155, temp.max);
 }
 
 test(DummyTempSensor) {
-	tempSens->temp = -13;
-	assertEqual(-13, tempSens->getTemp());
-	assertEqual(-13, tempSens->getQuickTemp());
+	tempSens->temp = temp_deg(-13);
+	assertEqual(temp_deg(-13), tempSens->getTemp());
+	assertEqual(temp_deg(-13), tempSens->getQuickTemp());
 
-	tempSens->temp = 72;
-	assertEqual(72, tempSens->getTemp());
-	assertEqual(72, tempSens->getQuickTemp());
+	tempSens->temp = temp_deg(72);
+	assertEqual(temp_deg(72), tempSens->getTemp());
+	assertEqual(temp_deg(72), tempSens->getQuickTemp());
 }
 
 void setup() {
@@ -14,7 +14,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#ifndef ENABLE_TEST_UTIL
 #define ENABLE_TEST_UTIL false
+#endif
 
 #if ENABLE_TEST_UTIL
 
@@ -38,8 +40,8 @@ test(util_abs16) {
 	assertEqual(2500, util_abs16(2500));
 }
 
-test(util_min_i8) {
-	int8_t arr[5];
+test(util_min_i16) {
+	int16_t arr[5];
 
 	arr[0] = 25;
 	arr[1] = -1;
@@ -47,12 +49,12 @@ test(util_min_i8) {
 	arr[3] = -16;
 	arr[4] = 2;
 
-	int8_t val = util_min_i8(arr, 5);
+	int16_t val = util_min_i16(arr, 5);
 	assertEqual(-16, val);
 }
 
-test(util_max_i8) {
-	int8_t arr[5];
+test(util_max_i16) {
+	int16_t arr[5];
 
 	arr[0] = 25;
 	arr[1] = -1;
@@ -60,12 +62,12 @@ test(util_max_i8) {
 	arr[3] = -16;
 	arr[4] = 2;
 
-	int8_t val = util_max_i8(arr, 5);
+	int16_t val = util_max_i16(arr, 5);
 	assertEqual(25, val);
 }
 
-test(util_avg_i8) {
-	int8_t arr[5];
+test(util_avg_i16) {
+	int16_t arr[5];
 
 	arr[0] = 25;
 	arr[1] = -1;
@@ -75,12 +77,12 @@ test(util_avg_i8) {
 	arr[3] = -16;
 	arr[4] = 2;
 
-	int8_t val = util_avg_i8(arr, 5);
+	int16_t val = util_avg_i16(arr, 5);
 	assertEqual(5, val);
 }
 
-test(util_sort_i8_t1) {
-	int8_t arr[5];
+test(util_sort_i16_t1) {
+	int16_t arr[5];
 
 	arr[0] = 25;
 	arr[1] = -1;
@@ -88,7 +90,7 @@ test(util_sort_i8_t1) {
 	arr[3] = -16;
 	arr[4] = 2;
 
-	util_sort_i8(arr, 5);
+	util_sort_i16(arr, 5);
 
 	assertEqual(-16, arr[0]);
 	assertEqual(-1, arr[1]);
@@ -97,18 +99,40 @@ test(util_sort_i8_t1) {
 	assertEqual(25, arr[4]);
 }
 
-test(util_sort_i8_t2) {
-	int8_t arr[2];
+test(util_sort_i16_t2) {
+	int16_t arr[2];
 
 	arr[0] = 25;
 	arr[1] = 2;
 
-	util_sort_i8(arr, 2);
+	util_sort_i16(arr, 2);
 
 	assertEqual(2, arr[0]);
 	assertEqual(25, arr[1]);
 }
 
+test(temp_fromRaw) {
+	assertEqual(215, temp_fromRaw(2752)); // 21.5
+	assertEqual(-50, temp_fromRaw(-640)); // -5.0
+	assertEqual(1, temp_fromRaw(8)); // 0.0625
+	assertEqual(-1, temp_fromRaw(-8));
+}
+
+test(temp_format) {
+	char buf[8];
+	assertEqual(0, strcmp("21.5", temp_format(buf, 215)));
+	assertEqual(0, strcmp("-0.5", temp_format(buf, -5)));
+	assertEqual(0, strcmp("-12.0", temp_format(buf, -120)));
+
+	assertEqual(0, strcmp("99.9", temp_formatShort(buf, 999)));
+	assertEqual(0, strcmp("-9.9", temp_formatShort(buf, -99)));
+	assertEqual(0, strcmp("-10", temp_formatShort(buf, -100)));
+	assertEqual(0, strcmp("-127", temp_formatShort(buf, temp_deg(-127))));
+	assertEqual(0, strcmp("257", temp_formatShort(buf, temp_toFahrenheit(temp_deg(125)))));
+	assertEqual(0, strcmp("-999", temp_formatShort(buf, -32768)));
+	assertEqual(0, strcmp("3277", temp_formatShort(buf, 32767)));
+}
+
 void setup() {
 #if ENABLE_LOGGER
 	log_setup();
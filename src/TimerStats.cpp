@@ -16,7 +16,8 @@
  */
 #include "TimerStats.h"
 
-TimerStats::TimerStats(){
+TimerStats::TimerStats() :
+		BusListener(ListenerSlot::TIMER_STATS, eb_mask(BusEventGroup::RELAY) | eb_mask(BusEvent::CLEAR_STATS)) {
 }
 
 TimerStats::~TimerStats() {
@@ -26,26 +27,22 @@ void TimerStats::init() {
 	systemTimer.start();
 }
 
-uint8_t TimerStats::listenerId() {
-	return DEVICE_ID_TIME_STATS;
-}
-
 // TODO store timers in EEPROM
 
-void TimerStats::onEvent(BusEvent event, va_list ap) {
-	if (eb_inGroup(event, BusEventGroup::RELAY)) {
-		int relayId = va_arg(ap, int);
+void TimerStats::onEvent(const BusMsg* msg) {
+	if (eb_inGroup(msg->event, BusEventGroup::RELAY)) {
+		uint8_t relayId = msg->data.relayId;
 
 #if TRACE
-		log(F("TSA RT:%d,%d"), relayId, event);
+		log(F("TSA RT:%d,%d"), relayId, msg->event);
 #endif
-		if (event == BusEvent::RELAY_ON) {
+		if (msg->event == BusEvent::RELAY_ON) {
 			relayTimer[relayId].start();
 
-		} else if (event == BusEvent::RELAY_OFF) {
+		} else if (msg->event == BusEvent::RELAY_OFF) {
 			relayTimer[relayId].suspend();
 		}
-	} else if (event == BusEvent::CLEAR_STATS) {
+	} else if (msg->event == BusEvent::CLEAR_STATS) {
 		//	clearStats();
 		//storage.clearDayHistory();
 	}
@@ -36,8 +36,7 @@ private:
 	Timer relayTimer[RELAYS_AMOUNT];
 
 	void clearStats();
-	uint8_t listenerId();
-	void onEvent(BusEvent event, va_list ap);
+	void onEvent(const BusMsg* msg);
 };
 
 #endif /* TIMERSTATS_H_ */
@@ -26,12 +26,11 @@ void util_setCycleMs(uint32_t ms);
 
 uint32_t util_ms();
 
-inline void util_sort_i8(int8_t arr[], uint8_t size) {
-	int8_t i, temp, j;
-	for (i = 1; i < size; i++) {
-		temp = arr[i];
-		j = i - 1;
-		while (temp < arr[j] && j >= 0) {
+inline void util_sort_i16(int16_t arr[], uint8_t size) {
+	for (int8_t i = 1; i < size; i++) {
+		int16_t temp = arr[i];
+		int8_t j = i - 1;
+		while (j >= 0 && temp < arr[j]) {
 			arr[j + 1] = arr[j];
 			j = j - 1;
 		}
@@ -39,24 +38,26 @@ inline void util_sort_i8(int8_t arr[], uint8_t size) {
 	}
 }
 
-inline int8_t util_avg_i8(int8_t arr[], uint8_t size) {
+/* Average rounded to the nearest integer. */
+inline int16_t util_avg_i16(int16_t arr[], uint8_t size) {
 	if (size == 0) {
 		return 0;
 	}
-	float tmp = 0;
+	int32_t sum = 0;
 	for (uint8_t i = 0; i < size; i++) {
-		tmp += arr[i];
+		sum += arr[i];
 	}
-	return (int8_t) (tmp / size + 0.5);
+	int32_t half = sum >= 0 ? size / 2 : -(size / 2);
+	return (sum + half) / size;
 }
 
-inline int8_t util_max_i8(int8_t arr[], uint8_t size) {
+inline int16_t util_max_i16(int16_t arr[], uint8_t size) {
 	if (size == 0) {
 		return 0;
 	}
-	int8_t tmp = arr[0];
+	int16_t tmp = arr[0];
 	for (uint8_t i = 1; i < size; i++) {
-		int8_t next = arr[i];
+		int16_t next = arr[i];
 		if (next > tmp) {
 			tmp = next;
 		}
@@ -64,13 +65,13 @@ inline int8_t util_max_i8(int8_t arr[], uint8_t size) {
 	return tmp;
 }
 
-inline int8_t util_min_i8(int8_t arr[], uint8_t size) {
+inline int16_t util_min_i16(int16_t arr[], uint8_t size) {
 	if (size == 0) {
 		return 0;
 	}
-	int8_t tmp = arr[0];
+	int16_t tmp = arr[0];
 	for (uint8_t i = 1; i < size; i++) {
-		int8_t next = arr[i];
+		int16_t next = arr[i];
 		if (next < tmp) {
 			tmp = next;
 		}
@@ -79,9 +80,22 @@ inline int8_t util_min_i8(int8_t arr[], uint8_t size) {
 }
 
 inline uint16_t util_freeRam() {
+#ifdef __AVR__
 	extern int __heap_start, *__brkval;
 	int v;
 	return (uint16_t) &v - (__brkval == 0 ? (int) &__heap_start : (int) __brkval);
+#else
+	return 0; // heap layout is known only on AVR
+#endif
+}
+
+/* Dallas/Maxim CRC8 (polynomial x^8 + x^5 + x^4 + 1), as used by DS18B20, one byte at a time starting from 0. */
+inline uint8_t util_crc8(uint8_t crc, uint8_t data) {
+	crc ^= data;
+	for (uint8_t bit = 0; bit < 8; bit++) {
+		crc = crc & 1 ? (crc >> 1) ^ 0x8C : crc >> 1;
+	}
+	return crc;
 }
 
 inline uint16_t util_abs16(int16_t val) {